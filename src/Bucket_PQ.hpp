@@ -4,6 +4,7 @@
 #include <vector>
 #include <limits>
 #include <cassert>
+#include <cstdint>
 #include <numeric>
 #include <stdexcept>
 #include <random>
@@ -163,4 +164,81 @@ private:
 	}
 };
 
+/** Keeps track of the elements with the largest value while values are increased, decreased or reset arbitrarily.
+ * Elements with value 0 are not stored in any bucket. Undoing a change is just another change back to the old value.
+ * Elements and positions are 32 bit, so an element takes 4 bytes and another 4 bytes while its value is not 0.
+ */
+class MaxBucketPQ
+{
+public:
+	using element_type = uint32_t;
+private:
+	static constexpr element_type invalid_pos = std::numeric_limits<element_type>::max();
+public:
+	MaxBucketPQ(size_t size) : pos(size, invalid_pos), buckets(1), max_val(0)
+	{
+		if (size >= invalid_pos) throw std::length_error("MaxBucketPQ supports less than 2^32 - 1 elements");
+	}
+
+	void change_key(size_t el, size_t old_val, size_t new_val)
+	{
+		assert(el < pos.size());
+		if (old_val == new_val) return;
+		if (old_val > 0) remove(el, old_val);
+		if (new_val > 0) insert(el, new_val);
+		// after the insertion, so that raising the maximal element does not scan the buckets below it
+		while (max_val > 0 && buckets[max_val].empty()) --max_val;
+	}
+
+	size_t max_value() const
+	{
+		return max_val;
+	}
+
+	/** All elements with value val > 0, in no particular order */
+	const std::vector<element_type>& elements_with(size_t val) const
+	{
+		assert(val > 0 && val < buckets.size());
+		return buckets[val];
+	}
+
+	void clear()
+	{
+		for (std::vector<element_type>& bucket : buckets)
+		{
+			for (element_type el : bucket) pos[el] = invalid_pos;
+			bucket.clear();
+		}
+		max_val = 0;
+	}
+
+private:
+	std::vector<element_type> pos; // Map an element to its position in its bucket
+	std::vector<std::vector<element_type>> buckets; // The elements, indexed by value, bucket 0 stays empty
+	size_t max_val;
+
+	void insert(size_t el, size_t val)
+	{
+		if (val >= buckets.size()) buckets.resize(val + 1);
+		assert(pos[el] == invalid_pos);
+		assert(buckets[val].size() < invalid_pos);
+
+		pos[el] = buckets[val].size();
+		buckets[val].push_back(el);
+		if (val > max_val) max_val = val;
+	}
+
+	void remove(size_t el, size_t val)
+	{
+		std::vector<element_type>& bucket = buckets[val];
+		const element_type i = pos[el];
+		assert(i < bucket.size() && bucket[i] == el);
+
+		bucket[i] = bucket.back();
+		pos[bucket[i]] = i;
+		bucket.pop_back();
+		pos[el] = invalid_pos;
+	}
+};
+
 #endif
@@ -5,6 +5,8 @@
 
 #include "../config.hpp"
 
+#include "../Finder/Finder.hpp"
+
 namespace Consumer
 {
 	/**
@@ -16,7 +18,11 @@ namespace Consumer
 	class Base_No_Updates
 	{
 	public:
+		using VertexID = typename Graph::VertexID;
+		using Edit_Delta = ::Finder::Edit_Delta<VertexID, length>;
 		static constexpr bool needs_subgraph_stats = false;
+		static constexpr bool needs_edit_delta = false;
+		static constexpr bool needs_subgraph_index = false;
 
 		struct State {};
 
@@ -31,7 +37,7 @@ namespace Consumer
 		{
 		};
 
-		void after_mark_and_edit(State&, Graph const &, Graph_Edits const &, VertexID, VertexID)
+		void after_mark_and_edit(State&, Graph const &, Graph_Edits const &, VertexID, VertexID, Edit_Delta const &)
 		{
 		};
 
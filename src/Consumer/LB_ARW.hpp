@@ -1,8 +1,16 @@
 #ifndef CONSUMER_LOWER_BOUND_ARW_HPP
 #define CONSUMER_LOWER_BOUND_ARW_HPP
 
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
 #include <vector>
+#include <random>
+#include <tuple>
+#include <utility>
 #include <stdexcept>
+#include <thread>
 #include <fstream>
 #include <sstream>
 #include <cstdio>
@@ -15,184 +23,464 @@
 #include "../Finder/Finder.hpp"
 #include "../Finder/SubgraphStats.hpp"
 #include "../LowerBound/Lower_Bound.hpp"
+#include "../LowerBound/Parameters.hpp"
 #include "../Graph/ValueMatrix.hpp"
 #include "../util.hpp"
 
 namespace Consumer
 {
 	template<typename Finder_impl, typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion, size_t length>
-	class ARW : Options::Tag::Lower_Bound
+	class ARW : Options::Tag::Lower_Bound, Options::Tag::Root_Bound, Options::Tag::Parameters
 	{
 	public:
 		static constexpr char const *name = "ARW";
+		using VertexID = typename Graph::VertexID;
 		using Lower_Bound_Storage_type = ::Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, length>;
 		using Subgraph_Stats_type = ::Finder::Subgraph_Stats<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>;
 		using subgraph_t = typename Lower_Bound_Storage_type::subgraph_t;
+		using Edit_Delta = ::Finder::Edit_Delta<VertexID, length>;
 
 		static constexpr bool needs_subgraph_stats = true;
+		static constexpr bool needs_edit_delta = true;
+		static constexpr bool needs_subgraph_index = false;
 
 		struct State {
 			Lower_Bound_Storage_type lb;
-			bool remove_last_subgraph = false;
 		};
 	private:
+		struct Tabu_Pair
+		{
+			VertexID u, v;
+			/* first round in which the pair is no longer tabu */
+			size_t until;
+		};
 
 		Graph_Edits candidate_pairs_used;
 		Finder_impl finder;
 		Graph_Edits bound_uses;
+		/* rounds of the local search, tabu tenure and (2,3)-swap candidates */
+		::Lower_Bound::Parameters parameters;
 	public:
 		ARW(VertexID graph_size) : candidate_pairs_used(graph_size), finder(graph_size), bound_uses(graph_size) {;}
 
 		State initialize(size_t k, Graph const &graph, Graph_Edits const &edited)
 		{
 			State state;
-
-			bound_uses.clear();
+			state.lb = Lower_Bound_Storage_type(graph.size());
 
 			finder.find(graph, [&](const subgraph_t& path)
 			{
-				bool touches_bound = Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-					return bound_uses.has_edge(*uit, *vit);
-				});
-
-				if (!touches_bound)
-				{
-					state.lb.add(path);
-
-					Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-						bound_uses.set_edge(*uit, *vit);
-						return false;
-					});
-				}
+				state.lb.add_if_disjoint(graph, edited, path);
 
 				// Assumption: if the bound is too high, initialize will be called again anyway.
 				return state.lb.size() > k;
-			}, bound_uses);
+			}, state.lb.used_pairs());
 
 			return state;
 		}
 
 		void set_initial_k(size_t, Graph const&, Graph_Edits const&) {}
 
-		void before_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		void set_parameters(::Lower_Bound::Parameters const &p)
 		{
-			std::vector<subgraph_t>& lb = state.lb.get_bound();
-			assert(!state.remove_last_subgraph);
+			parameters = p;
+		}
 
-			for (size_t i = 0; i < lb.size(); ++i)
-			{
-				bool has_uv = ::Finder::for_all_edges_unordered<Mode, Restriction, Conversion, Graph, Graph_Edits>(graph, edited, lb[i].begin(), lb[i].end(), [&](auto x, auto y)
-				{
-					return (u == *x && v == *y) || (u == *y && v == *x);
-				});
+		void before_mark_and_edit(State& state, Graph const &, Graph_Edits const &, VertexID u, VertexID v)
+		{
+			state.lb.remove_for_edit(u, v);
+		}
 
-				if (has_uv)
+		void after_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID, VertexID, Edit_Delta const &delta)
+		{
+			state.lb.update(graph, edited, finder, [&](auto &add_new)
+			{
+				for (const subgraph_t& path : delta.created)
 				{
-					assert(i+1 == lb.size() || !state.remove_last_subgraph);
-					state.remove_last_subgraph = true;
-					std::swap(lb[i], lb.back());
+					add_new(path);
 				}
-			}
+			});
 		}
 
-		void after_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		void after_undo_edit(State&, Graph const&, Graph_Edits const&, VertexID, VertexID)
 		{
-			subgraph_t removed_subgraph;
+		}
 
-			if (state.remove_last_subgraph) {
-				removed_subgraph = state.lb.get_bound().back();
-				state.lb.get_bound().pop_back();
-			}
+		void before_mark(State&, Graph const &, Graph_Edits const &, VertexID, VertexID)
+		{
+		}
+
+		void after_mark(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		{
+			state.lb.release(u, v);
+			state.lb.update(graph, edited, finder, [&](auto &add_new)
+			{
+				finder.find_near(graph, u, v, add_new, state.lb.used_pairs());
+			});
+		}
 
-			initialize_bound_uses(state, graph, edited);
+		void after_unmark(Graph const&, Graph_Edits const&, VertexID, VertexID)
+		{
+		}
 
-			auto add_to_bound_if_possible = [&](const subgraph_t& path)
+		size_t result(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, Graph const &g, Graph_Edits const &e, Options::Tag::Lower_Bound)
+		{
+			if (state.lb.size() <= k)
 			{
-				bool touches_bound = Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-					return bound_uses.has_edge(*uit, *vit);
-				});
+				improve_bound(state, subgraph_stats, k, g, e, initial_seed(subgraph_stats));
+			}
 
-				if (!touches_bound)
-				{
-					state.lb.add(path);
+			state.lb.assert_maximal(g, e, finder);
 
-					Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-						bound_uses.set_edge(*uit, *vit);
-						return false;
-					});
-				}
+			return state.lb.size();
+		}
 
-				return false;
-			};
+		/**
+		 * Runs @a threads independently seeded local searches on copies of the bound and keeps the largest packing.
+		 * The search with the first seed is the one result(..., Options::Tag::Lower_Bound) runs, so the bound is never worse.
+		 */
+		size_t result(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, Graph const &g, Graph_Edits const &e, size_t threads, Options::Tag::Root_Bound)
+		{
+			if (!Graph::concurrent_reads || !Graph_Edits::concurrent_reads || threads <= 1 || state.lb.size() > k)
+			{
+				return result(state, subgraph_stats, k, g, e, Options::Tag::Lower_Bound());
+			}
 
-			finder.find_near(graph, u, v, add_to_bound_if_possible, bound_uses);
-			if (state.remove_last_subgraph) {
-				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, removed_subgraph.begin(), removed_subgraph.end(), [&](auto uit, auto vit) {
-					if (!bound_uses.has_edge(*uit, *vit)) {
-						finder.find_near(graph, *uit, *vit, add_to_bound_if_possible, bound_uses);
-					}
+			const uint64_t seed = initial_seed(subgraph_stats);
+			std::vector<ARW> searchers(threads - 1, *this);
+			std::vector<State> states(threads - 1, state);
 
-					return false;
+			std::vector<std::thread> workers;
+			for (size_t t = 0; t + 1 < threads; ++t)
+			{
+				workers.emplace_back([&, t]()
+				{
+					searchers[t].improve_bound(states[t], subgraph_stats, k, g, e, seed + t + 1);
 				});
+			}
+
+			improve_bound(state, subgraph_stats, k, g, e, seed);
 
-				state.remove_last_subgraph = false;
+			for (auto &w : workers) {w.join();}
+
+			for (State& other : states)
+			{
+				if (other.lb.size() > state.lb.size()) {state = std::move(other);}
 			}
 
-			state.lb.assert_maximal(graph, edited, finder);
+			state.lb.assert_maximal(g, e, finder);
+
+			return state.lb.size();
 		}
 
-		void after_undo_edit(State&, Graph const&, Graph_Edits const&, VertexID, VertexID)
+	private:
+		static uint64_t initial_seed(const Subgraph_Stats_type& subgraph_stats)
 		{
+			return 42 * subgraph_stats.num_subgraphs + subgraph_stats.sum_subgraphs_per_edge;
 		}
 
-		void before_mark(State&, Graph const &, Graph_Edits const &, VertexID, VertexID)
+		/**
+		 * Improves the bound by (1,2)-swaps until they stop helping.
+		 * If the bound is close to k, or at the root where k is unknown, an iterated local search with perturbations and (2,3)-swaps follows.
+		 */
+		void improve_bound(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, const Graph &g, const Graph_Edits &e, uint64_t seed)
 		{
+			std::mt19937_64 gen(seed);
+
+			bound_uses = state.lb.used_pairs();
+			find_lb_2_improvements(state, subgraph_stats, k, g, e, gen);
+
+			size_t rounds = 0;
+			if (k == std::numeric_limits<size_t>::max())
+			{
+				rounds = parameters.root_perturbation_rounds;
+			}
+			else if (state.lb.size() <= k && k - state.lb.size() < parameters.perturbation_rounds_per_gap.size())
+			{
+				rounds = parameters.perturbation_rounds_per_gap[k - state.lb.size()];
+			}
+
+			if (rounds > 0)
+			{
+				iterated_local_search(state, subgraph_stats, k, g, e, gen, rounds);
+			}
 		}
 
-		void after_mark(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		/**
+		 * Each round forces a random subgraph next to the bound into it, evicting the bound subgraphs it conflicts with, and searches for improvements around the changed subgraphs.
+		 * The result is kept unless the bound shrank. Pairs of forced subgraphs are tabu for parameters.tabu_tenure rounds: the subgraphs using them are not evicted.
+		 */
+		void iterated_local_search(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, const Graph &g, const Graph_Edits &e, std::mt19937_64 &gen, size_t rounds)
 		{
-			after_mark_and_edit(state, graph, edited, u, v);
+			std::vector<Tabu_Pair> tabu;
+			std::vector<subgraph_t> focus;
+
+			// a full pass of (2,3)-swaps only pays off once, at the root
+			if (k == std::numeric_limits<size_t>::max())
+			{
+				focus = std::as_const(state.lb).get_bound();
+				search_around(state, subgraph_stats, k, g, e, gen, focus);
+			}
+
+			Lower_Bound_Storage_type best = state.lb;
+			for (size_t round = 0; round < rounds && state.lb.size() <= k; ++round)
+			{
+				if (best.size() < state.lb.size()) {best = state.lb;}
+				else if (best.size() > state.lb.size()) {state.lb = best;}
+
+				tabu.erase(std::remove_if(tabu.begin(), tabu.end(), [&](const Tabu_Pair &t) {return t.until <= round;}), tabu.end());
+				focus.clear();
+				if (perturb(state, g, e, gen, tabu, round, focus))
+				{
+					search_around(state, subgraph_stats, k, g, e, gen, focus);
+				}
+			}
+
+			if (best.size() > state.lb.size()) {state.lb = std::move(best);}
+			state.lb.assert_valid(g, e);
 		}
 
-		void after_unmark(Graph const&, Graph_Edits const&, VertexID, VertexID)
+		/** (1,2)- and (2,3)-swaps of the subgraphs in focus, subgraphs added by successful swaps join focus */
+		void search_around(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, const Graph &g, const Graph_Edits &e, std::mt19937_64 &gen, std::vector<subgraph_t> &focus)
 		{
+			size_t searched = 0, swapped = 0;
+			do
+			{
+				bound_uses = state.lb.used_pairs();
+				find_lb_2_improvements(state, subgraph_stats, k, g, e, gen, &focus, searched);
+				searched = focus.size();
+			}
+			while (state.lb.size() <= k && find_2_3_swap(state, k, g, e, gen, focus, swapped));
 		}
 
-		size_t result(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, Graph const &g, Graph_Edits const &e, Options::Tag::Lower_Bound)
+		/** Forces a random subgraph sharing a pair with a random bound subgraph into the bound, the subgraphs added to the bound are appended to added */
+		bool perturb(State& state, const Graph &g, const Graph_Edits &e, std::mt19937_64 &gen, std::vector<Tabu_Pair> &tabu, size_t round, std::vector<subgraph_t> &added)
 		{
-			if (state.lb.size() <= k)
+			if (state.lb.empty()) return false;
+
+			auto is_tabu = [&](VertexID x, VertexID y)
 			{
-				initialize_bound_uses(state, g, e);
-				find_lb_2_improvements(state, subgraph_stats, k, g, e);
-			}
+				return std::any_of(tabu.begin(), tabu.end(), [&](const Tabu_Pair &t) {return (t.u == x && t.v == y) || (t.u == y && t.v == x);});
+			};
 
-			state.lb.assert_maximal(g, e, finder);
+			const size_t i = std::uniform_int_distribution<size_t>(0, state.lb.size() - 1)(gen);
+			std::vector<std::pair<VertexID, VertexID>> pairs = editable_pairs(g, e, state.lb[i]);
+			if (pairs.empty()) return false;
+			const auto [u, v] = pairs[std::uniform_int_distribution<size_t>(0, pairs.size() - 1)(gen)];
 
-			return state.lb.size();
+			// choose uniformly among the subgraphs at (u, v) that evict no subgraph holding a tabu pair
+			subgraph_t forced;
+			size_t num_choices = 0;
+			finder.find_near(g, u, v, [&](const subgraph_t &sg)
+			{
+				bool blocked = false, is_bound_subgraph = true;
+				for_editable_pairs(g, e, sg, [&](VertexID x, VertexID y)
+				{
+					const size_t j = state.lb.find(x, y);
+					is_bound_subgraph &= (j == i);
+					if (j != Lower_Bound_Storage_type::none)
+					{
+						for_editable_pairs(g, e, state.lb[j], [&](VertexID a, VertexID b) {blocked |= is_tabu(a, b);});
+					}
+				});
+
+				if (!blocked && !is_bound_subgraph && std::uniform_int_distribution<size_t>(0, num_choices++)(gen) == 0)
+				{
+					forced = sg;
+				}
+				return false;
+			});
+			if (num_choices == 0) return false;
+
+			std::vector<size_t> evicted;
+			for_editable_pairs(g, e, forced, [&](VertexID x, VertexID y)
+			{
+				const size_t j = state.lb.find(x, y);
+				if (j != Lower_Bound_Storage_type::none && std::find(evicted.begin(), evicted.end(), j) == evicted.end()) {evicted.push_back(j);}
+			});
+
+			// removing from the back keeps the indices of the other evicted subgraphs valid
+			std::sort(evicted.begin(), evicted.end(), std::greater<size_t>());
+			std::vector<subgraph_t> removed;
+			for (size_t j : evicted) {removed.push_back(state.lb.remove_at(j));}
+
+			state.lb.add(g, e, forced);
+			added.push_back(forced);
+			for_editable_pairs(g, e, forced, [&](VertexID x, VertexID y) {tabu.push_back({x, y, round + parameters.tabu_tenure});});
+
+			// the pairs of the evicted subgraphs may allow new subgraphs
+			auto add_to_bound_if_possible = [&](const subgraph_t &path)
+			{
+				if (state.lb.add_if_disjoint(g, e, path)) {added.push_back(path);}
+				return false;
+			};
+			for (const subgraph_t &fs : removed)
+			{
+				for_editable_pairs(g, e, fs, [&](VertexID x, VertexID y)
+				{
+					if (!state.lb.used_pairs().has_edge(x, y))
+					{
+						finder.find_near(g, x, y, add_to_bound_if_possible, state.lb.used_pairs());
+					}
+				});
+			}
+
+			state.lb.assert_valid(g, e);
+			return true;
 		}
 
-	private:
-		void initialize_bound_uses(const State& state, const Graph& graph, const Graph_Edits &edited)
+		/**
+		 * Looks for a subgraph a in focus[begin, end) and another bound subgraph b that can be replaced by three subgraphs.
+		 * b is only considered if some subgraph conflicts with a and b and with no other bound subgraph.
+		 * Returns true after the first successful swap, the three new subgraphs are appended to focus and begin is where the search continues.
+		 */
+		bool find_2_3_swap(State& state, size_t k, const Graph &g, const Graph_Edits &e, std::mt19937_64 &gen, std::vector<subgraph_t> &focus, size_t &begin)
 		{
-			bound_uses.clear();
-
-			for (const subgraph_t& path : state.lb.get_bound())
+			std::vector<size_t> neighbors;
+			std::vector<subgraph_t> candidates;
+			std::vector<std::tuple<VertexID, VertexID, size_t>> candidate_pairs;
+			// Parameters::set() keeps max_swap_candidates below Packed_Bits, so the conflicts of a candidate fit in one Packed
+			std::array<Packed, Packed_Bits> conflicts;
+			const size_t max_swap_candidates = parameters.max_swap_candidates;
+			assert(max_swap_candidates < Packed_Bits);
+
+			bound_uses = state.lb.used_pairs();
+			for (; begin < focus.size() && state.lb.size() <= k; ++begin)
 			{
-				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-					bound_uses.set_edge(*uit, *vit);
-					return false;
+				const subgraph_t a = focus[begin];
+				const size_t ai = index_of(state, g, e, a);
+				if (ai == Lower_Bound_Storage_type::none) continue;
+
+				neighbors.clear();
+				for_editable_pairs(g, e, a, [&](VertexID x, VertexID y)
+				{
+					finder.find_near(g, x, y, [&](const subgraph_t &sg)
+					{
+						size_t other = Lower_Bound_Storage_type::none;
+						bool single = true;
+						for_editable_pairs(g, e, sg, [&](VertexID p, VertexID q)
+						{
+							const size_t j = state.lb.find(p, q);
+							if (j == Lower_Bound_Storage_type::none || j == ai) return;
+							if (other == Lower_Bound_Storage_type::none) {other = j;}
+							else if (other != j) {single = false;}
+						});
+						if (single && other != Lower_Bound_Storage_type::none) {neighbors.push_back(other);}
+						return false;
+					});
 				});
+				std::sort(neighbors.begin(), neighbors.end());
+				neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+				std::shuffle(neighbors.begin(), neighbors.end(), gen);
+
+				const auto a_pairs = editable_pairs(g, e, a);
+				for (size_t bi : neighbors)
+				{
+					const auto b_pairs = editable_pairs(g, e, state.lb[bi]);
+
+					// bound_uses is the bound without a and b
+					for (auto [x, y] : a_pairs) {bound_uses.clear_edge(x, y);}
+					for (auto [x, y] : b_pairs) {bound_uses.clear_edge(x, y);}
+
+					candidates.clear();
+					auto collect = [&](const subgraph_t &sg)
+					{
+						candidates.push_back(sg);
+						return candidates.size() >= max_swap_candidates;
+					};
+					for (auto [x, y] : a_pairs) {if (candidates.size() < max_swap_candidates) finder.find_near(g, x, y, collect, bound_uses);}
+					for (auto [x, y] : b_pairs) {if (candidates.size() < max_swap_candidates) finder.find_near(g, x, y, collect, bound_uses);}
+
+					for (auto [x, y] : a_pairs) {bound_uses.set_edge(x, y);}
+					for (auto [x, y] : b_pairs) {bound_uses.set_edge(x, y);}
+
+					// conflicts[c] has bit d set if candidates c and d share a pair
+					candidate_pairs.clear();
+					for (size_t c = 0; c < candidates.size(); ++c)
+					{
+						for_editable_pairs(g, e, candidates[c], [&](VertexID x, VertexID y) {candidate_pairs.emplace_back(std::min(x, y), std::max(x, y), c);});
+					}
+					std::sort(candidate_pairs.begin(), candidate_pairs.end());
+
+					std::fill(conflicts.begin(), conflicts.end(), 0);
+					for (size_t first = 0, last = 0; first < candidate_pairs.size(); first = last)
+					{
+						Packed sharing = 0;
+						for (last = first; last < candidate_pairs.size() && std::get<0>(candidate_pairs[last]) == std::get<0>(candidate_pairs[first]) && std::get<1>(candidate_pairs[last]) == std::get<1>(candidate_pairs[first]); ++last)
+						{
+							sharing |= Packed(1) << std::get<2>(candidate_pairs[last]);
+						}
+						for (size_t i = first; i < last; ++i) {conflicts[std::get<2>(candidate_pairs[i])] |= sharing;}
+					}
+
+					for (size_t c1 = 0; c1 < candidates.size(); ++c1)
+					{
+						const Packed after_c1 = ~conflicts[c1] & ~((Packed(2) << c1) - 1) & ((Packed(1) << candidates.size()) - 1);
+						for (Packed m2 = after_c1; m2; m2 &= m2 - 1)
+						{
+							const size_t c2 = PACKED_CTZ(m2);
+							const Packed m3 = after_c1 & ~conflicts[c2] & ~((Packed(2) << c2) - 1);
+							if (!m3) continue;
+							const size_t c3 = PACKED_CTZ(m3);
+
+							// removing the larger index first keeps the smaller one valid
+							state.lb.remove_at(std::max(ai, bi));
+							state.lb.remove_at(std::min(ai, bi));
+							for (size_t c : {c1, c2, c3})
+							{
+								state.lb.add(g, e, candidates[c]);
+								focus.push_back(candidates[c]);
+							}
+							state.lb.assert_valid(g, e);
+							++begin;
+							return true;
+						}
+					}
+				}
 			}
+
+			return false;
+		}
+
+		/** Index of sg in the bound, none if it is not part of it */
+		static size_t index_of(const State& state, const Graph &g, const Graph_Edits &e, const subgraph_t &sg)
+		{
+			size_t i = Lower_Bound_Storage_type::none;
+			Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(g, e, sg.begin(), sg.end(), [&](auto uit, auto vit)
+			{
+				i = state.lb.find(*uit, *vit);
+				return true;
+			});
+			return (i != Lower_Bound_Storage_type::none && state.lb[i] == sg) ? i : Lower_Bound_Storage_type::none;
+		}
+
+		template <typename F>
+		static void for_editable_pairs(const Graph &g, const Graph_Edits &e, const subgraph_t &sg, F callback)
+		{
+			Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(g, e, sg.begin(), sg.end(), [&](auto uit, auto vit)
+			{
+				callback(*uit, *vit);
+				return false;
+			});
 		}
 
-		void find_lb_2_improvements(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, const Graph &g, const Graph_Edits &e)
+		static std::vector<std::pair<VertexID, VertexID>> editable_pairs(const Graph &g, const Graph_Edits &e, const subgraph_t &sg)
 		{
-			std::vector<subgraph_t>& lb = state.lb.get_bound();
+			std::vector<std::pair<VertexID, VertexID>> pairs;
+			for_editable_pairs(g, e, sg, [&](VertexID x, VertexID y) {pairs.emplace_back(x, y);});
+			return pairs;
+		}
 
+		/**
+		 * Replaces bound subgraphs by one or two subgraphs, in rounds over the shuffled bound until no improvement is found.
+		 * With focus, only the subgraphs focus[focus_begin, end) are tried once, subgraphs added by improvements are appended to focus.
+		 */
+		void find_lb_2_improvements(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, const Graph &g, const Graph_Edits &e, std::mt19937_64 &gen, std::vector<subgraph_t> *focus = nullptr, size_t focus_begin = 0)
+		{
 			std::vector<std::vector<subgraph_t>> candidates_per_pair(length * (length - 1) / 2);
 			std::vector<std::pair<VertexID, VertexID>> pairs;
+			std::vector<subgraph_t> partners;
 
-			std::mt19937_64 gen(42 * subgraph_stats.num_subgraphs + subgraph_stats.sum_subgraphs_per_edge);
 			std::uniform_real_distribution prob(.0, 1.0);
 
 
@@ -204,12 +492,15 @@ namespace Consumer
 				improvement_found = false;
 				bound_changed = false;
 
-				std::shuffle(lb.begin(), lb.end(), gen);
+				if (!focus) {state.lb.shuffle(gen);}
 
-				for (size_t fsi = 0; fsi < lb.size(); ++fsi)
+				for (size_t step = focus ? focus_begin : 0; step < (focus ? focus->size() : state.lb.size()); ++step)
 				{
-					auto fs = lb[fsi];
+					const size_t fsi = focus ? index_of(state, g, e, (*focus)[step]) : step;
+					if (fsi == Lower_Bound_Storage_type::none) continue;
+					auto fs = state.lb[fsi];
 					pairs.clear();
+					partners.clear();
 
 					// See how many candidates we have
 					size_t num_pairs = 0, num_neighbors = 0;
@@ -394,7 +685,7 @@ namespace Consumer
 											improvement_found = true;
 
 											// Directly add the partner to the lower bound, continue search to see if there is more than one partner
-											lb.push_back(partner_fs);
+											partners.push_back(partner_fs);
 
 											Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(g, e, partner_fs.begin(), partner_fs.end(), [&bound_uses = bound_uses](auto cuit, auto cvit)
 											{
@@ -408,7 +699,16 @@ namespace Consumer
 
 								if (found_partner)
 								{
-									lb[fsi] = cand_fs;
+									state.lb.replace(fsi, g, e, cand_fs);
+									for (const subgraph_t& partner_fs : partners)
+									{
+										state.lb.add(g, e, partner_fs);
+									}
+									if (focus)
+									{
+										focus->push_back(cand_fs);
+										focus->insert(focus->end(), partners.begin(), partners.end());
+									}
 
 									state.lb.assert_valid(g, e);
 									break;
@@ -437,7 +737,7 @@ namespace Consumer
 									return false;
 								});
 
-								lb[fsi] = min_candidate;
+								state.lb.replace(fsi, g, e, min_candidate);
 								state.lb.assert_valid(g, e);
 
 								bound_changed = true;
@@ -466,7 +766,7 @@ namespace Consumer
 				{
 					++rounds_no_improvement;
 				}
-			} while (improvement_found || (rounds_no_improvement < 5 && bound_changed));
+			} while (!focus && (improvement_found || (rounds_no_improvement < 5 && bound_changed)));
 
 		}
 
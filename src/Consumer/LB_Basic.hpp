@@ -18,6 +18,7 @@ namespace Consumer
 	{
 	public:
 		static constexpr char const *name = "Basic";
+		using VertexID = typename Graph::VertexID;
 		using Lower_Bound_Storage_type = ::Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, length>;
 		using subgraph_t = typename Lower_Bound_Storage_type::subgraph_t;
 		using State = typename Base_No_Updates<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>::State;
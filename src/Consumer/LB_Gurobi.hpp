@@ -9,6 +9,8 @@
 #include <cmath>
 #include <iostream>
 #include <memory>
+#include <tuple>
+#include <utility>
 #include <gurobi_c++.h>
 
 #include "../config.hpp"
@@ -28,24 +30,43 @@ namespace Consumer
 	{
 	public:
 		static constexpr char const *name = "Gurobi";
+		using VertexID = typename Graph::VertexID;
 		using Lower_Bound_Storage_type = ::Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, length>;
 		using Subgraph_Stats_type = ::Finder::Subgraph_Stats<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>;
 		using subgraph_t = typename Lower_Bound_Storage_type::subgraph_t;
+		using Edit_Delta = ::Finder::Edit_Delta<VertexID, length>;
 
 		static constexpr bool needs_subgraph_stats = true;
+		static constexpr bool needs_edit_delta = true;
+		static constexpr bool needs_subgraph_index = false;
 
 		struct State {
+			/* pairs marked on the way to this node, a pair is only fixed while it is still marked */
+			std::vector<std::pair<VertexID, VertexID>> marked;
+			/* forbidden subgraphs created by the edits on the way to this node */
+			std::vector<subgraph_t> cuts;
 		};
 	private:
+		/** The graph and constraints of the root, shared read-only by all copies of the consumer */
+		struct Root_Model
+		{
+			Graph graph;
+			std::vector<subgraph_t> subgraphs;
+		};
 
 		Finder_impl finder;
+		std::shared_ptr<const Root_Model> root;
+		/* every copy, i.e., every worker of MT, solves with its own environment and model */
 		std::unique_ptr<GRBEnv> env;
 		std::unique_ptr<GRBModel> model;
 		Value_Matrix<GRBVar> variables;
 		size_t initial_k;
 		size_t objective_offset;
 		bool shall_solve;
-		std::vector<std::vector<GRBConstr>> constraint_stack;
+		/* the pairs fixed in the model and the cuts added to the constraints of the root, as of the last synced state */
+		std::vector<std::pair<VertexID, VertexID>> fixed;
+		std::vector<subgraph_t> cuts;
+		std::vector<GRBConstr> cut_constraints;
 
 		size_t solve() {
 			model->optimize();
@@ -116,51 +137,106 @@ namespace Consumer
 			var.set(GRB_DoubleAttr_UB, 1.0);
 		}
 
-		size_t add_forbidden_subgraphs(const Graph& graph, Finder_impl& finder) {
-			size_t num_found = 0;
+		/** Builds the model of the root in the own environment, without any fixed pairs or cuts */
+		void build_model() {
+			model = std::make_unique<GRBModel>(*env);
+			model->set(GRB_IntParam_Threads,	1);
+			model->getEnv().set(GRB_IntParam_OutputFlag, 1);
+			model->getEnv().set(GRB_IntParam_LogToConsole, 0);
+			GRBLinExpr objective = 0;
+			objective_offset = 0;
 
-			finder.find(graph, [&](const subgraph_t& fs) {
-				++num_found;
-				add_constraint(fs);
-				return false;
+			variables.forAllNodePairs([&](VertexID u, VertexID v, GRBVar& var) {
+				var = model->addVar(0.0, 1.0, 0.0, GRB_CONTINUOUS);
+				if (root->graph.has_edge(u, v)) {
+					objective -= var;
+					++objective_offset;
+				} else {
+					objective += var;
+				}
 			});
 
-			std::cerr << "added " << num_found << " constraints" << std::endl;
-			return num_found;
+			objective += objective_offset;
+			model->setObjective(objective, GRB_MINIMIZE);
+
+			for (const subgraph_t& fs : root->subgraphs) {
+				add_constraint(fs);
+			}
+
+			fixed.clear();
+			cuts.clear();
+			cut_constraints.clear();
+			shall_solve = true;
+		}
+
+		/**
+		 * Brings the bounds and cuts of the model to the node of state. With MT consecutive calls may be far apart in the search tree,
+		 * e.g., after the worker picked up a new work package.
+		 */
+		void sync(const State& state, const Graph& graph, const Graph_Edits& edited) {
+			size_t common = 0;
+			while (common < cuts.size() && common < state.cuts.size() && cuts[common] == state.cuts[common]) {
+				++common;
+			}
+
+			// Neither removing cuts nor relaxing pairs makes the last solution infeasible or the bound higher, see relax_pair
+			for (size_t i = common; i < cut_constraints.size(); ++i) {
+				model->remove(cut_constraints[i]);
+			}
+
+			cuts.resize(common);
+			cut_constraints.resize(common);
+
+			for (auto [u, v] : fixed) {
+				relax_pair(u, v);
+			}
+
+			fixed.clear();
+
+			for (auto [u, v] : state.marked) {
+				if (!edited.has_edge(u, v)) continue;
+				fix_pair(u, v, graph.has_edge(u, v));
+				fixed.emplace_back(u, v);
+			}
+
+			for (size_t i = common; i < state.cuts.size(); ++i) {
+				cuts.push_back(state.cuts[i]);
+				cut_constraints.push_back(add_constraint(state.cuts[i]));
+				if (!shall_solve && get_constraint_value(state.cuts[i], graph, edited) < 0.999) {
+					shall_solve = true;
+				}
+			}
 		}
 	public:
-		Gurobi(VertexID graph_size) : finder(graph_size), env(std::make_unique<GRBEnv>()), variables(graph_size), initial_k(0), shall_solve(true) {}
+		Gurobi(VertexID graph_size) : finder(graph_size), env(std::make_unique<GRBEnv>()), variables(graph_size), initial_k(0), objective_offset(0), shall_solve(true) {}
 
-		Gurobi(const Gurobi& o) : finder(o.finder), variables(o.variables) { throw std::runtime_error("Not implemented"); }
+		/** Copies share the constraints of the root but get their own environment and model, the bounds are set by the states passed in */
+		Gurobi(const Gurobi& o) : finder(o.finder), root(o.root), env(std::make_unique<GRBEnv>()), variables(o.variables.size()), initial_k(o.initial_k), objective_offset(0), shall_solve(true)
+		{
+			if (root) {
+				try {
+					build_model();
+				} catch (GRBException &e) {
+					std::cerr << e.getMessage() << std::endl;
+					throw e;
+				}
+			}
+		}
 
 		Gurobi(Gurobi&& o) = default;
 
 		State initialize(size_t, const Graph &graph, Graph_Edits const &/*edited*/)
 		{
 			try {
-				model = std::make_unique<GRBModel>(*env);
-				model->set(GRB_IntParam_Threads,	1);
-				model->getEnv().set(GRB_IntParam_OutputFlag, 1);
-				model->getEnv().set(GRB_IntParam_LogToConsole, 0);
-				GRBLinExpr objective = 0;
-				objective_offset = 0;
-
-				variables.forAllNodePairs([&](VertexID u, VertexID v, GRBVar& var) {
-					var = model->addVar(0.0, 1.0, 0.0, GRB_CONTINUOUS);
-					if (graph.has_edge(u, v)) {
-						objective -= var;
-						++objective_offset;
-					} else {
-						objective += var;
-					}
+				auto root_model = std::make_shared<Root_Model>(Root_Model{graph, {}});
+				finder.find(graph, [&](const subgraph_t& fs) {
+					root_model->subgraphs.push_back(fs);
+					return false;
 				});
 
-				objective += objective_offset;
-				model->setObjective(objective, GRB_MINIMIZE);
-
-				add_forbidden_subgraphs(graph, finder);
-
-				shall_solve = true;
+				std::cerr << "added " << root_model->subgraphs.size() << " constraints" << std::endl;
+				root = std::move(root_model);
+				build_model();
 
 /*
 				size_t num_constraints_added = 0;
@@ -210,106 +286,34 @@ namespace Consumer
 		{
 		}
 
-		void after_mark_and_edit(State&, Graph &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		void after_mark_and_edit(State& state, Graph const &, Graph_Edits const &, VertexID u, VertexID v, Edit_Delta const &delta)
 		{
-			try {
-				fix_pair(u, v, graph.has_edge(u, v));
-
-				if (false) {
-					GRBColumn col = model->getCol(variables.at(u, v));
-					for (size_t i = 0; i < col.size(); ++i) {
-						GRBConstr constr = col.getConstr(i);
-						model->remove(constr);
-					}
-				}
-
-				constraint_stack.emplace_back();
-
-				if (shall_solve) {
-					assert(initial_k > 0);
-					if (solve() > initial_k) return;
-					shall_solve = false;
-				}
-
-				finder.find_near(graph, u, v, [&](const subgraph_t& path)
-				{
-					constraint_stack.back().push_back(add_constraint(path));
-					if (!shall_solve && get_constraint_value(path, graph, edited) < 0.999) {
-						shall_solve = true;
-					}
-
-					return false;
-				});
-			} catch (GRBException &e) {
-				std::cerr << e.getMessage() << std::endl;
-				throw e;
-			}
-
-/*
-			if (shall_solve) {
-				if (solve() > initial_k) return;
-				shall_solve = false;
-			}
-
-			variables.forAllNodePairs([&](VertexID u, VertexID v, GRBVar& var) {
-				const double val = var.get(GRB_DoubleAttr_X);
-				bool has_edge = graph.has_edge(u, v);
-				if ((has_edge && val < 0.999) || (!has_edge && val > 0.001)) {
-					graph.toggle_edge(u, v);
-
-					finder.find_near(graph, u, v, [&](const subgraph_t& path)
-					{
-						if (get_constraint_value(path, graph, edited) < 0.999) {
-							constraint_stack.back().push_back(add_constraint(path));
-							shall_solve = true;
-						}
-
-						return false;
-					});
-
-					graph.toggle_edge(u, v);
-				}
-			});
-*/
+			// only recorded, the model is synced with the state when it is needed
+			state.marked.emplace_back(u, v);
+			state.cuts.insert(state.cuts.end(), delta.created.begin(), delta.created.end());
 		}
 
-		void after_undo_edit(State&, Graph const&graph, Graph_Edits const&, VertexID u, VertexID v)
+		void after_undo_edit(State&, Graph const&, Graph_Edits const&, VertexID, VertexID)
 		{
-			try {
-				fix_pair(u, v, graph.has_edge(u, v));
-
-				for (GRBConstr cstr : constraint_stack.back()) {
-					model->remove(cstr);
-				}
-
-				constraint_stack.pop_back();
-			} catch (GRBException &e) {
-				std::cerr << e.getMessage() << std::endl;
-				throw e;
-			}
 		}
 
 		void before_mark(State&, Graph const &, Graph_Edits const &, VertexID, VertexID)
 		{
 		}
 
-		void after_mark(State&, Graph const &, Graph_Edits const &, VertexID, VertexID)
+		void after_mark(State& state, Graph const &, Graph_Edits const &, VertexID u, VertexID v)
 		{
+			state.marked.emplace_back(u, v);
 		}
 
-		void after_unmark(Graph const&, Graph_Edits const&, VertexID u, VertexID v)
+		void after_unmark(Graph const&, Graph_Edits const&, VertexID, VertexID)
 		{
-			try {
-				relax_pair(u, v);
-			} catch (GRBException &e) {
-				std::cerr << e.getMessage() << std::endl;
-				throw e;
-			}
 		}
 
-		size_t result(State&, const Subgraph_Stats_type&, size_t, Graph const &, Graph_Edits const &, Options::Tag::Lower_Bound)
+		size_t result(State& state, const Subgraph_Stats_type&, size_t, Graph const &graph, Graph_Edits const &edited, Options::Tag::Lower_Bound)
 		{
 			try {
+				sync(state, graph, edited);
 				if (shall_solve) {
 					size_t result = solve();
 					if (result > initial_k) {
@@ -346,9 +350,16 @@ namespace Consumer
 		};
 
 	public:
-		ProblemSet result(State&, const Subgraph_Stats_type& subgraph_stats, size_t k, Graph const &graph, Graph_Edits const &edited, Options::Tag::Selector)
+		ProblemSet<VertexID> result(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, Graph const &graph, Graph_Edits const &edited, Options::Tag::Selector)
 		{
-			ProblemSet problem;
+			try {
+				sync(state, graph, edited);
+			} catch (GRBException &e) {
+				std::cerr << e.getMessage() << std::endl;
+				throw e;
+			}
+
+			ProblemSet<VertexID> problem;
 			problem.found_solution = (subgraph_stats.num_subgraphs == 0);
 			problem.needs_no_edit_branch = false;
 			if (!problem.found_solution && k > 0 && !shall_solve) {
@@ -0,0 +1,158 @@
+#ifndef CONSUMER_LOWER_BOUND_MIS_HPP
+#define CONSUMER_LOWER_BOUND_MIS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "../config.hpp"
+
+#include "../Options.hpp"
+#include "../Finder/Finder.hpp"
+#include "../Finder/SubgraphStats.hpp"
+#include "../LowerBound/Lower_Bound.hpp"
+#include "../LowerBound/Branch_And_Reduce.hpp"
+#include "LB_ARW.hpp"
+
+namespace Consumer
+{
+	/**
+	 * The ARW bound, but the bound of the root is the largest packing found by a branch-and-reduce maximum independent set search
+	 * on the conflict graph of all forbidden subgraphs, if it beats the local search within the time limit.
+	 */
+	template<typename Finder_impl, typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion, size_t length>
+	class MIS : public ARW<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>
+	{
+		using Base = ARW<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>;
+	public:
+		static constexpr char const *name = "MIS";
+		using typename Base::VertexID;
+		using typename Base::Lower_Bound_Storage_type;
+		using typename Base::Subgraph_Stats_type;
+		using typename Base::subgraph_t;
+		using typename Base::State;
+		using Vertex = ::Lower_Bound::Branch_And_Reduce::Vertex;
+
+	private:
+		/* the conflict graph is only built for at most this many forbidden subgraphs */
+		static constexpr size_t max_subgraphs = size_t(1) << 18;
+		/* and if it has at most this many edges, counted twice and with multiplicity */
+		static constexpr size_t max_conflicts = size_t(1) << 25;
+
+		Finder_impl finder;
+		/* time for the independent set search at the root, after the local search */
+		std::chrono::duration<double> time_limit{10};
+	public:
+		MIS(VertexID graph_size) : Base(graph_size), finder(graph_size) {;}
+
+		void set_parameters(::Lower_Bound::Parameters const &parameters)
+		{
+			Base::set_parameters(parameters);
+			time_limit = std::chrono::duration<double>(parameters.mis_time);
+		}
+
+		using Base::result;
+
+		size_t result(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, Graph const &g, Graph_Edits const &e, size_t threads, Options::Tag::Root_Bound)
+		{
+			Base::result(state, subgraph_stats, k, g, e, threads, Options::Tag::Root_Bound());
+			if (state.lb.size() > k || subgraph_stats.num_subgraphs > max_subgraphs || time_limit.count() <= 0)
+			{
+				return state.lb.size();
+			}
+
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(time_limit);
+
+			std::vector<subgraph_t> subgraphs;
+			subgraphs.reserve(subgraph_stats.num_subgraphs);
+			finder.find(g, [&](const subgraph_t& sg)
+			{
+				subgraphs.push_back(sg);
+				return false;
+			});
+
+			// subgraphs conflict if they share an editable pair, group them by pair
+			std::vector<std::pair<size_t, Vertex>> pair_members;
+			for (Vertex i = 0; i < subgraphs.size(); ++i)
+			{
+				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(g, e, subgraphs[i].begin(), subgraphs[i].end(), [&](auto uit, auto vit)
+				{
+					const auto [u, v] = std::minmax(*uit, *vit);
+					pair_members.emplace_back(size_t(u) * g.size() + v, i);
+					return false;
+				});
+			}
+
+			std::sort(pair_members.begin(), pair_members.end());
+
+			size_t conflicts = 0;
+			for_pair_groups(pair_members, [&](auto begin, auto end)
+			{
+				conflicts += (end - begin) * (end - begin - 1);
+			});
+
+			if (conflicts > max_conflicts)
+			{
+				return state.lb.size();
+			}
+
+			std::vector<std::vector<Vertex>> adjacency(subgraphs.size());
+			for_pair_groups(pair_members, [&](auto begin, auto end)
+			{
+				for (auto it = begin; it != end; ++it)
+				{
+					for (auto jt = begin; jt != end; ++jt)
+					{
+						if (it != jt) {adjacency[it->second].push_back(jt->second);}
+					}
+				}
+			});
+
+			for (std::vector<Vertex>& neighbors : adjacency)
+			{
+				std::sort(neighbors.begin(), neighbors.end());
+				neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+			}
+
+			::Lower_Bound::Branch_And_Reduce solver(std::move(adjacency));
+			const std::vector<Vertex> independent_set = solver.solve(deadline, state.lb.size());
+
+			if (independent_set.size() > state.lb.size())
+			{
+				Lower_Bound_Storage_type lb(g.size());
+				for (Vertex i : independent_set)
+				{
+					lb.add(g, e, subgraphs[i]);
+				}
+
+				// without a proof of optimality the set may not be maximal
+				for (const subgraph_t& sg : subgraphs)
+				{
+					lb.add_if_disjoint(g, e, sg);
+				}
+
+				state.lb = std::move(lb);
+			}
+
+			state.lb.assert_maximal(g, e, finder);
+
+			return state.lb.size();
+		}
+
+	private:
+		/** Calls f(begin, end) for each range of pair_members with the same pair */
+		template<typename F>
+		static void for_pair_groups(const std::vector<std::pair<size_t, Vertex>>& pair_members, F f)
+		{
+			for (auto begin = pair_members.begin(); begin != pair_members.end();)
+			{
+				auto end = std::find_if(begin, pair_members.end(), [&](const auto& m) {return m.first != begin->first;});
+				f(begin, end);
+				begin = end;
+			}
+		}
+	};
+}
+
+#endif
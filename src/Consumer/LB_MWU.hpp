@@ -0,0 +1,273 @@
+#ifndef CONSUMER_LOWER_BOUND_MWU_HPP
+#define CONSUMER_LOWER_BOUND_MWU_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "../config.hpp"
+
+#include "../Options.hpp"
+#include "../Finder/Finder.hpp"
+#include "../Finder/SubgraphStats.hpp"
+#include "../LowerBound/Lower_Bound.hpp"
+#include "../Graph/PairMap.hpp"
+
+namespace Consumer
+{
+	/**
+	 * Approximates the LP relaxation of packing forbidden subgraphs into the editable pairs by multiplicative weights (Garg-Könemann).
+	 * Any packing with fractional weights where each pair carries at most 1 bounds the number of edits, the packing found is scaled down until it is one.
+	 * The packing is kept in the state, so the search at a node continues from the packing of its parent.
+	 * As in Garg-Könemann, the length of a pair is exponential in its load.
+	 */
+	template<typename Finder_impl, typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion, size_t length>
+	class MWU : Options::Tag::Lower_Bound
+	{
+	public:
+		static constexpr char const *name = "MWU";
+		using VertexID = typename Graph::VertexID;
+		using Lower_Bound_Storage_type = ::Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, length>;
+		using subgraph_t = typename Lower_Bound_Storage_type::subgraph_t;
+		using Subgraph_Stats_type = ::Finder::Subgraph_Stats<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>;
+		using Edit_Delta = ::Finder::Edit_Delta<VertexID, length>;
+
+		static constexpr bool needs_subgraph_stats = false;
+		static constexpr bool needs_edit_delta = false;
+		static constexpr bool needs_subgraph_index = false;
+
+		struct Packed_Subgraph
+		{
+			subgraph_t subgraph;
+			double weight;
+
+			bool operator<(const Packed_Subgraph& other) const
+			{
+				return subgraph < other.subgraph;
+			}
+		};
+
+		struct State {
+			/* the unscaled packing of the last result(), sorted by subgraph */
+			std::vector<Packed_Subgraph> packing;
+		};
+	private:
+		/* each pass adds all subgraphs at most this factor longer than the shortest one, a pair gets this factor longer per unit of load */
+		static constexpr double epsilon = 0.1;
+		static constexpr size_t passes = 64;
+		/* passes without a packing to continue from, as at the root */
+		static constexpr size_t initial_passes = 256;
+		/* the packing of the parent is scaled down to at most this load per pair */
+		static constexpr double max_inherited_load = passes;
+		/* the packing value is rounded up after subtracting this, to be safe against rounding errors */
+		static constexpr double tolerance = 1e-6;
+		/* the state keeps only this many of the heaviest subgraphs of the packing */
+		static constexpr size_t max_packed_subgraphs = 1024;
+
+		Finder_impl finder;
+
+		/* scratch space, so each thread has its own: the pairs of the current subgraphs, numbered by pair_id */
+		::Graph::Pair_Map pair_id;
+		std::vector<double> pair_length;
+		std::vector<double> pair_load;
+		std::vector<bool> pair_used;
+		std::vector<subgraph_t> subgraphs;
+		std::vector<double> subgraph_weight;
+		/* length of each subgraph at the start of the current pass */
+		std::vector<double> start_length;
+		/* pair ids of the subgraphs, subgraph i has those from subgraph_begin[i] to subgraph_begin[i + 1] */
+		std::vector<size_t> subgraph_pairs;
+		std::vector<size_t> subgraph_begin;
+	public:
+		MWU(VertexID graph_size) : finder(graph_size) {;}
+
+		State initialize(size_t, Graph const &, Graph_Edits const &)
+		{
+			return State{};
+		}
+
+		void set_initial_k(size_t, Graph const&, Graph_Edits const&) {}
+
+		void before_mark_and_edit(State&, Graph const &, Graph_Edits const &, VertexID, VertexID)
+		{
+		}
+
+		void after_mark_and_edit(State&, Graph const &, Graph_Edits const &, VertexID, VertexID, Edit_Delta const &)
+		{
+		}
+
+		void after_undo_edit(State&, Graph const&, Graph_Edits const&, VertexID, VertexID)
+		{
+		}
+
+		void before_mark(State&, Graph const &, Graph_Edits const &, VertexID, VertexID)
+		{
+		}
+
+		void after_mark(State&, Graph const &, Graph_Edits const &, VertexID, VertexID)
+		{
+		}
+
+		void after_unmark(Graph const&, Graph_Edits const&, VertexID, VertexID)
+		{
+		}
+
+		size_t result(State& state, const Subgraph_Stats_type&, size_t k, Graph const &graph, Graph_Edits const &edited, Options::Tag::Lower_Bound)
+		{
+			clear();
+
+			// collect the subgraphs and pack them greedily, which is an integral packing already
+			size_t greedy = 0;
+			bool unbreakable = false;
+			finder.find(graph, [&](const subgraph_t& path)
+			{
+				bool touches_used = false;
+				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit)
+				{
+					size_t id = pair_id.find(*uit, *vit);
+					if (id == ::Graph::Pair_Map::none)
+					{
+						id = pair_id.size();
+						pair_id.set(*uit, *vit, id);
+					}
+
+					subgraph_pairs.push_back(id);
+					touches_used |= id < pair_used.size() && pair_used[id];
+					return false;
+				});
+
+				if (subgraph_pairs.size() == subgraph_begin.back())
+				{
+					// no pair of the subgraph may be edited
+					unbreakable = true;
+					return true;
+				}
+
+				pair_used.resize(pair_id.size(), false);
+				if (!touches_used)
+				{
+					++greedy;
+					for (size_t i = subgraph_begin.back(); i < subgraph_pairs.size(); ++i) {pair_used[subgraph_pairs[i]] = true;}
+				}
+
+				subgraphs.push_back(path);
+				subgraph_begin.push_back(subgraph_pairs.size());
+				return greedy > k;
+			});
+
+			if (unbreakable)
+			{
+				return std::numeric_limits<size_t>::max();
+			}
+
+			if (greedy > k || subgraph_begin.size() == 1)
+			{
+				return greedy;
+			}
+
+			// subgraphs of the parent's packing that were destroyed or lost all editable pairs drop out, the rest stays a packing
+			const size_t num_subgraphs = subgraphs.size();
+			subgraph_weight.assign(num_subgraphs, 0.0);
+			pair_load.assign(pair_id.size(), 0.0);
+			for (size_t i = 0; i < num_subgraphs; ++i)
+			{
+				auto it = std::lower_bound(state.packing.begin(), state.packing.end(), Packed_Subgraph{subgraphs[i], 0.0});
+				if (it == state.packing.end() || it->subgraph != subgraphs[i]) continue;
+
+				subgraph_weight[i] = it->weight;
+				for (size_t j = subgraph_begin[i]; j < subgraph_begin[i + 1]; ++j) {pair_load[subgraph_pairs[j]] += it->weight;}
+			}
+
+			double packed = std::accumulate(subgraph_weight.begin(), subgraph_weight.end(), 0.0);
+			double max_load = *std::max_element(pair_load.begin(), pair_load.end());
+			if (max_load > max_inherited_load)
+			{
+				// scaling keeps it a packing and lets the passes of this node weigh as much as those of all ancestors
+				const double factor = max_inherited_load / max_load;
+				for (double& w : subgraph_weight) {w *= factor;}
+				for (double& l : pair_load) {l *= factor;}
+				packed *= factor;
+				max_load = max_inherited_load;
+			}
+
+			pair_length.resize(pair_id.size());
+			for (size_t id = 0; id < pair_id.size(); ++id)
+			{
+				pair_length[id] = std::pow(1 + epsilon, pair_load[id] - max_load);
+			}
+
+			auto subgraph_length = [&](size_t i)
+			{
+				double sum = 0;
+				for (size_t j = subgraph_begin[i]; j < subgraph_begin[i + 1]; ++j) {sum += pair_length[subgraph_pairs[j]];}
+				return sum;
+			};
+
+			auto scaled_bound = [&]()
+			{
+				return max_load > 0 ? static_cast<size_t>(std::ceil(packed / max_load - tolerance)) : 0;
+			};
+
+			size_t bound = std::max(greedy, scaled_bound());
+			const size_t num_passes = state.packing.empty() ? initial_passes : passes;
+			for (size_t pass = 0; pass < num_passes && bound <= k; ++pass)
+			{
+				double shortest = std::numeric_limits<double>::infinity();
+				start_length.resize(num_subgraphs);
+				for (size_t i = 0; i < num_subgraphs; ++i)
+				{
+					start_length[i] = subgraph_length(i);
+					shortest = std::min(shortest, start_length[i]);
+				}
+
+				const double threshold = shortest * (1 + epsilon);
+				for (size_t i = 0; i < num_subgraphs; ++i)
+				{
+					// lengths only grow during a pass, only subgraphs short enough at its start need to be measured again
+					if (start_length[i] > threshold || subgraph_length(i) > threshold) continue;
+
+					subgraph_weight[i] += 1;
+					packed += 1;
+					for (size_t j = subgraph_begin[i]; j < subgraph_begin[i + 1]; ++j)
+					{
+						max_load = std::max(max_load, pair_load[subgraph_pairs[j]] += 1);
+						pair_length[subgraph_pairs[j]] *= 1 + epsilon;
+					}
+				}
+
+				bound = std::max(bound, scaled_bound());
+			}
+
+			state.packing.clear();
+			for (size_t i = 0; i < num_subgraphs; ++i)
+			{
+				if (subgraph_weight[i] > 0) {state.packing.push_back(Packed_Subgraph{subgraphs[i], subgraph_weight[i]});}
+			}
+
+			// dropping subgraphs keeps it a packing, the children start from the heaviest ones
+			if (state.packing.size() > max_packed_subgraphs)
+			{
+				std::nth_element(state.packing.begin(), state.packing.begin() + max_packed_subgraphs, state.packing.end(), [](const Packed_Subgraph& a, const Packed_Subgraph& b) {return a.weight > b.weight;});
+				state.packing.resize(max_packed_subgraphs);
+			}
+
+			std::sort(state.packing.begin(), state.packing.end());
+
+			return bound;
+		}
+
+	private:
+		void clear()
+		{
+			pair_id.clear();
+			pair_used.clear();
+			subgraphs.clear();
+			subgraph_pairs.clear();
+			subgraph_begin.assign(1, 0);
+		}
+	};
+}
+
+#endif
@@ -15,7 +15,6 @@
 #include "../Finder/Finder.hpp"
 #include "../LowerBound/Lower_Bound.hpp"
 #include "../Bucket_PQ.hpp"
-#include "../Graph/ValueMatrix.hpp"
 #include "../util.hpp"
 
 namespace Consumer
@@ -25,96 +24,47 @@ namespace Consumer
 	{
 	public:
 		static constexpr char const *name = "Min_Deg";
+		using VertexID = typename Graph::VertexID;
 		using Lower_Bound_Storage_type = ::Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, length>;
 		using subgraph_t = typename Lower_Bound_Storage_type::subgraph_t;
+		using Edit_Delta = ::Finder::Edit_Delta<VertexID, length>;
 		using Subgraph_Stats_type = ::Finder::Subgraph_Stats<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>;
+		using Subgraph_Index_type = decltype(Subgraph_Stats_type::index);
 
-		static constexpr bool needs_subgraph_stats = false;
+		static constexpr bool needs_subgraph_stats = true;
+		static constexpr bool needs_edit_delta = true;
+		static constexpr bool needs_subgraph_index = true;
 		struct State {
 			Lower_Bound_Storage_type lb;
-			bool remove_last_subgraph = false;
 		};
 	private:
-		std::vector<subgraph_t> forbidden_subgraphs;
-		Value_Matrix<std::vector<size_t>> subgraphs_per_edge;
-
-		Graph_Edits bound_uses;
 		Finder_impl finder;
 	public:
-		Min_Deg(VertexID graph_size) : subgraphs_per_edge(graph_size), bound_uses(graph_size), finder(graph_size) {;}
+		Min_Deg(VertexID graph_size) : finder(graph_size) {;}
 
-		State initialize(size_t, Graph const &, Graph_Edits const &)
+		State initialize(size_t, Graph const &graph, Graph_Edits const &)
 		{
-			return State{};
+			State state;
+			state.lb = Lower_Bound_Storage_type(graph.size());
+			return state;
 		}
 
 		void set_initial_k(size_t, Graph const&, Graph_Edits const&) {}
 
-		void before_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		void before_mark_and_edit(State& state, Graph const &, Graph_Edits const &, VertexID u, VertexID v)
 		{
-			std::vector<subgraph_t>& lb = state.lb.get_bound();
-			assert(!state.remove_last_subgraph);
-
-			for (size_t i = 0; i < lb.size(); ++i)
-			{
-				bool has_uv = ::Finder::for_all_edges_unordered<Mode, Restriction, Conversion, Graph, Graph_Edits>(graph, edited, lb[i].begin(), lb[i].end(), [&](auto x, auto y)
-				{
-					return (u == *x && v == *y) || (u == *y && v == *x);
-				});
-
-				if (has_uv)
-				{
-					assert(i+1 == lb.size() || !state.remove_last_subgraph);
-					state.remove_last_subgraph = true;
-					std::swap(lb[i], lb.back());
-				}
-			}
+			state.lb.remove_for_edit(u, v);
 		}
 
-		void after_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		void after_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID, VertexID, Edit_Delta const &delta)
 		{
-			subgraph_t removed_subgraph;
-
-			if (state.remove_last_subgraph) {
-				removed_subgraph = state.lb.get_bound().back();
-				state.lb.get_bound().pop_back();
-			}
-
-			initialize_bound_uses(state, graph, edited);
-
-			auto add_to_bound_if_possible = [&](const subgraph_t& path)
+			state.lb.update(graph, edited, finder, [&](auto &add_new)
 			{
-				bool touches_bound = Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-					return bound_uses.has_edge(*uit, *vit);
-				});
-
-				if (!touches_bound)
+				for (const subgraph_t& path : delta.created)
 				{
-					state.lb.add(path);
-
-					Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-						bound_uses.set_edge(*uit, *vit);
-						return false;
-					});
+					add_new(path);
 				}
-
-				return false;
-			};
-
-			finder.find_near(graph, u, v, add_to_bound_if_possible, bound_uses);
-			if (state.remove_last_subgraph) {
-				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, removed_subgraph.begin(), removed_subgraph.end(), [&](auto uit, auto vit) {
-					if (!bound_uses.has_edge(*uit, *vit)) {
-						finder.find_near(graph, *uit, *vit, add_to_bound_if_possible, bound_uses);
-					}
-
-					return false;
-				});
-
-				state.remove_last_subgraph = false;
-			}
-
-			state.lb.assert_maximal(graph, edited, finder);
+			});
 		}
 
 		void after_undo_edit(State&, Graph const&, Graph_Edits const&, VertexID, VertexID)
@@ -127,17 +77,21 @@ namespace Consumer
 
 		void after_mark(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
 		{
-			after_mark_and_edit(state, graph, edited, u, v);
+			state.lb.release(u, v);
+			state.lb.update(graph, edited, finder, [&](auto &add_new)
+			{
+				finder.find_near(graph, u, v, add_new, state.lb.used_pairs());
+			});
 		}
 
 		void after_unmark(Graph const&, Graph_Edits const&, VertexID, VertexID)
 		{
 		}
 
-		size_t result(State& state, const Subgraph_Stats_type&, size_t k, Graph const &graph, Graph_Edits const &edited, Options::Tag::Lower_Bound)
+		size_t result(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, Graph const &graph, Graph_Edits const &edited, Options::Tag::Lower_Bound)
 		{
 			if (state.lb.size() <= k) {
-				Lower_Bound_Storage_type lb = calculate_min_deg_bound(graph, edited, k);
+				Lower_Bound_Storage_type lb = calculate_min_deg_bound(graph, edited, subgraph_stats, k);
 				if (lb.size() >= state.lb.size()) {
 					state.lb = lb;
 				}
@@ -150,92 +104,57 @@ namespace Consumer
 			return state.lb.size();
 		}
 	private:
-		void initialize_bound_uses(const State& state, const Graph& graph, const Graph_Edits &edited)
+		/** Greedy packing of the subgraphs in the subgraph index, always taking a subgraph that shares editable pairs with the fewest others */
+		Lower_Bound_Storage_type calculate_min_deg_bound(Graph const &graph, const Graph_Edits &edited, Subgraph_Stats_type const &subgraph_stats, size_t k)
 		{
-			bound_uses.clear();
+			Subgraph_Index_type const &index = subgraph_stats.index;
+			Lower_Bound_Storage_type result(graph.size());
+			if (index.size() == 0) {return result;}
 
-			for (const subgraph_t& path : state.lb.get_bound())
-			{
-				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-					bound_uses.set_edge(*uit, *vit);
-					return false;
-				});
-			}
-		}
-
-		Lower_Bound_Storage_type calculate_min_deg_bound(Graph const &graph, const Graph_Edits &edited, size_t k)
-		{
-			forbidden_subgraphs.clear();
-			subgraphs_per_edge.forAllNodePairs([&](VertexID, VertexID, std::vector<size_t>& v) { v.clear(); });
-			bound_uses.clear();
-			size_t sum_subgraphs_per_edge = 0;
-
-			finder.find(graph, [&](const subgraph_t& path)
-			{
-				const size_t forbidden_index = forbidden_subgraphs.size();
-				forbidden_subgraphs.push_back(path);
-
-				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-					subgraphs_per_edge.at(*uit, *vit).push_back(forbidden_index);
-					sum_subgraphs_per_edge++;
-					return false;
-				});
-				return false;
-			});
-
-			Lower_Bound_Storage_type result;
-
-			auto enumerate_neighbor_ids = [&subgraphs_per_edge = subgraphs_per_edge, &graph, &edited](const typename Lower_Bound_Storage_type::subgraph_t& fs, auto callback) {
+			auto enumerate_neighbor_ids = [&index, &graph, &edited](size_t id, auto callback) {
+				const subgraph_t &fs = index.get(id);
 				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, fs.begin(), fs.end(), [&](auto uit, auto vit) {
-					const auto& new_neighbors = subgraphs_per_edge.at(*uit, *vit);
-					for (size_t ne : new_neighbors)
-					{
-						callback(ne);
-					}
-
+					index.for_subgraphs_at(*uit, *vit, callback);
 					return false;
 				});
 			};
 
-			BucketPQ pq(forbidden_subgraphs.size(), 42 * forbidden_subgraphs.size() + sum_subgraphs_per_edge);
-
-			for (size_t fsid = 0; fsid < forbidden_subgraphs.size(); ++fsid) {
-				const subgraph_t& fs = forbidden_subgraphs[fsid];
+			BucketPQ pq(index.id_bound(), 42 * index.size() + subgraph_stats.sum_subgraphs_per_edge);
 
+			index.for_all([&](size_t fsid) {
+				const subgraph_t &fs = index.get(fsid);
 				size_t neighbor_count = 0;
-				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, fs.begin(), fs.end(), [&neighbor_count, &subgraphs_per_edge = subgraphs_per_edge](auto uit, auto vit) {
-					neighbor_count += subgraphs_per_edge.at(*uit, *vit).size();
+				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, fs.begin(), fs.end(), [&](auto uit, auto vit) {
+					neighbor_count += subgraph_stats.num_subgraphs_per_edge.at(*uit, *vit);
 					return false;
 				});
 
 				pq.insert(fsid, neighbor_count);
-			}
+			});
 
-			if (!pq.empty()) {
-				pq.build();
+			pq.build();
 
-				while (!pq.empty()) {
-					auto idkey = pq.pop();
+			while (!pq.empty()) {
+				auto idkey = pq.pop();
 
-					const auto& fs = forbidden_subgraphs[idkey.first];
+				const auto& fs = index.get(idkey.first);
 
-					result.add(fs.begin(), fs.end());
-					if (k > 0 && result.size() > k) break;
+				result.add(graph, edited, fs);
+				if (k > 0 && result.size() > k) break;
 
-					if (idkey.second > 1) {
-						enumerate_neighbor_ids(fs, [&pq, &enumerate_neighbor_ids, &forbidden_subgraphs = forbidden_subgraphs](size_t nfsid)
-						{
-							if (pq.contains(nfsid)) {
-								pq.erase(nfsid);
-								enumerate_neighbor_ids(forbidden_subgraphs[nfsid], [&pq](size_t nnfsid)
-								{
-									if (pq.contains(nnfsid)) {
-										pq.decrease_key_by_one(nnfsid);
-									}
-								});
-							}
-						});
-					}
+				if (idkey.second > 1) {
+					enumerate_neighbor_ids(idkey.first, [&pq, &enumerate_neighbor_ids](size_t nfsid)
+					{
+						if (pq.contains(nfsid)) {
+							pq.erase(nfsid);
+							enumerate_neighbor_ids(nfsid, [&pq](size_t nnfsid)
+							{
+								if (pq.contains(nnfsid)) {
+									pq.decrease_key_by_one(nnfsid);
+								}
+							});
+						}
+					});
 				}
 			}
 
@@ -243,36 +162,6 @@ namespace Consumer
 
 			return result;
 		}
-
-
-		// Some code to simplify the graph, seems to make results worse in fact.
-		void clean_graph_structure(Graph const&g, Graph_Edits const &e)
-		{
-			size_t num_cleared = 0;
-			subgraphs_per_edge.forAllNodePairs([&](VertexID u, VertexID v, std::vector<size_t>& subgraphs) {
-				if (subgraphs.empty()) return;
-
-				auto fs = forbidden_subgraphs[subgraphs.front()];
-
-				if (u > v) std::swap(u, v);
-
-				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(g, e, fs.begin(), fs.end(), [&](auto xit, auto yit) {
-					size_t x = *xit, y = *yit;
-					if (x > y) std::swap(x, y);
-					if (u == x && v == y) return false;
-
-					std::vector<size_t> &inner_subgraphs = subgraphs_per_edge.at(x, y);
-					if (subgraphs.size() <= inner_subgraphs.size() && std::includes(inner_subgraphs.begin(), inner_subgraphs.end(), subgraphs.begin(), subgraphs.end()))
-					{
-						subgraphs.clear();
-						++num_cleared;
-						return true;
-					}
-
-					return false;
-				});
-			});
-		}
 	};
 }
 
@@ -17,6 +17,7 @@ namespace Consumer
 	{
 	public:
 		static constexpr char const *name = "No";
+		using VertexID = typename Graph::VertexID;
 		using State = typename Base_No_Updates<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>::State;
 		using Subgraph_Stats_type = ::Finder::Subgraph_Stats<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>;
 	public:
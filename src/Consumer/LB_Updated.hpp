@@ -18,117 +18,54 @@ namespace Consumer
 	{
 	public:
 		static constexpr char const *name = "Updated";
+		using VertexID = typename Graph::VertexID;
 		using Subgraph_Stats_type = ::Finder::Subgraph_Stats<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>;
 		using Lower_Bound_Storage_type = ::Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, length>;
 		using subgraph_t = typename Lower_Bound_Storage_type::subgraph_t;
+		using Edit_Delta = ::Finder::Edit_Delta<VertexID, length>;
 
 		static constexpr bool needs_subgraph_stats = false;
+		static constexpr bool needs_edit_delta = true;
+		static constexpr bool needs_subgraph_index = false;
 		struct State {
 			Lower_Bound_Storage_type lb;
-			bool remove_last_subgraph = false;
 		};
 
 	private:
-		Graph_Edits bound_uses;
 		Finder_impl finder;
 	public:
-		Updated(VertexID graph_size) : bound_uses(graph_size), finder(graph_size) {}
+		Updated(VertexID graph_size) : finder(graph_size) {}
 
 		State initialize(size_t, Graph const &graph, Graph_Edits const &edited)
 		{
 			State state;
-
-			bound_uses.clear();
+			state.lb = Lower_Bound_Storage_type(graph.size());
 
 			finder.find(graph, [&](const subgraph_t& path)
 			{
-				bool touches_bound = Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-					return bound_uses.has_edge(*uit, *vit);
-				});
-
-				if (!touches_bound)
-				{
-					state.lb.add(path);
-
-					Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-						bound_uses.set_edge(*uit, *vit);
-						return false;
-					});
-				}
-
+				state.lb.add_if_disjoint(graph, edited, path);
 				return false;
-			}, bound_uses);
+			}, state.lb.used_pairs());
 
 			return state;
 		}
 
 		void set_initial_k(size_t, Graph const&, Graph_Edits const&) {}
 
-		void before_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		void before_mark_and_edit(State& state, Graph const &, Graph_Edits const &, VertexID u, VertexID v)
 		{
-			std::vector<subgraph_t>& lb = state.lb.get_bound();
-			assert(!state.remove_last_subgraph);
-
-			for (size_t i = 0; i < lb.size(); ++i)
-			{
-				bool has_uv = ::Finder::for_all_edges_unordered<Mode, Restriction, Conversion, Graph, Graph_Edits>(graph, edited, lb[i].begin(), lb[i].end(), [&](auto x, auto y)
-				{
-					return (u == *x && v == *y) || (u == *y && v == *x);
-				});
-
-				if (has_uv)
-				{
-					assert(i+1 == lb.size() || !state.remove_last_subgraph);
-					state.remove_last_subgraph = true;
-					std::swap(lb[i], lb.back());
-				}
-			}
+			state.lb.remove_for_edit(u, v);
 		}
 
-		void after_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		void after_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID, VertexID, Edit_Delta const &delta)
 		{
-			subgraph_t removed_subgraph;
-
-			if (state.remove_last_subgraph) {
-				removed_subgraph = state.lb.get_bound().back();
-				state.lb.get_bound().pop_back();
-			}
-
-			initialize_bound_uses(state, graph, edited);
-
-			auto add_to_bound_if_possible = [&](const subgraph_t& path)
+			state.lb.update(graph, edited, finder, [&](auto &add_new)
 			{
-				bool touches_bound = Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-					return bound_uses.has_edge(*uit, *vit);
-				});
-
-				if (!touches_bound)
+				for (const subgraph_t& path : delta.created)
 				{
-					state.lb.add(path);
-
-					Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-						bound_uses.set_edge(*uit, *vit);
-						return false;
-					});
+					add_new(path);
 				}
-
-				return false;
-			};
-
-			finder.find_near(graph, u, v, add_to_bound_if_possible, bound_uses);
-			if (state.remove_last_subgraph) {
-				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, removed_subgraph.begin(), removed_subgraph.end(), [&](auto uit, auto vit) {
-					if (!bound_uses.has_edge(*uit, *vit)) {
-						finder.find_near(graph, *uit, *vit, add_to_bound_if_possible, bound_uses);
-					}
-
-					return false;
-				});
-
-				state.remove_last_subgraph = false;
-			}
-
-			state.lb.assert_maximal(graph, edited, finder);
+			});
 		}
 
 		void after_undo_edit(State&, Graph const&, Graph_Edits const&, VertexID, VertexID)
@@ -141,7 +78,11 @@ namespace Consumer
 
 		void after_mark(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
 		{
-			after_mark_and_edit(state, graph, edited, u, v);
+			state.lb.release(u, v);
+			state.lb.update(graph, edited, finder, [&](auto &add_new)
+			{
+				finder.find_near(graph, u, v, add_new, state.lb.used_pairs());
+			});
 		}
 
 		void after_unmark(Graph const&, Graph_Edits const&, VertexID, VertexID)
@@ -153,19 +94,6 @@ namespace Consumer
 			state.lb.assert_maximal(graph, edited, finder);
 			return state.lb.size();
 		}
-	private:
-		void initialize_bound_uses(const State& state, const Graph& graph, const Graph_Edits &edited)
-		{
-			bound_uses.clear();
-
-			for (const subgraph_t& path : state.lb.get_bound())
-			{
-				Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-					bound_uses.set_edge(*uit, *vit);
-					return false;
-				});
-			}
-		}
 	};
 }
 
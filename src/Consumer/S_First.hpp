@@ -18,6 +18,7 @@ namespace Consumer
 	{
 	public:
 		static constexpr char const *name = "First";
+		using VertexID = typename Graph::VertexID;
 		using State = typename Base_No_Updates<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>::State;
 		using Lower_Bound_Storage_type = ::Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, length>;
 		using subgraph_t = typename Lower_Bound_Storage_type::subgraph_t;
@@ -29,9 +30,9 @@ namespace Consumer
 	public:
 		First(VertexID graph_size) : finder(graph_size) {;}
 
-		ProblemSet const result(State&, const Subgraph_Stats_type&, size_t, Graph const &graph, Graph const &edited, Options::Tag::Selector)
+		ProblemSet<VertexID> const result(State&, const Subgraph_Stats_type&, size_t, Graph const &graph, Graph_Edits const &edited, Options::Tag::Selector)
 		{
-			ProblemSet problem;
+			ProblemSet<VertexID> problem;
 			problem.found_solution = true;
 			problem.needs_no_edit_branch = false;
 
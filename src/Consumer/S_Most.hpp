@@ -27,11 +27,15 @@ namespace Consumer
 	class Most_Impl : Options::Tag::Selector
 	{
 	public:
+		using VertexID = typename Graph::VertexID;
 		using Lower_Bound_Storage_type = ::Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, length>;
 		using Subgraph_Stats_type = ::Finder::Subgraph_Stats<Finder_impl, Graph, Graph_Edits, Mode, Restriction, Conversion, length>;
 		using subgraph_t = typename Lower_Bound_Storage_type::subgraph_t;
+		using Edit_Delta = ::Finder::Edit_Delta<VertexID, length>;
 
 		static constexpr bool needs_subgraph_stats = true;
+		static constexpr bool needs_edit_delta = true;
+		static constexpr bool needs_subgraph_index = false;
 
 		struct State
 		{
@@ -107,9 +111,9 @@ namespace Consumer
 		{
 		}
 
-		void after_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		void after_mark_and_edit(State& state, Graph const &graph, Graph_Edits const &edited, VertexID, VertexID, Edit_Delta const &delta)
 		{
-			finder.find_near(graph, u, v, [&](const subgraph_t& path)
+			for (const subgraph_t& path : delta.created)
 			{
 				size_t free = 0;
 
@@ -126,9 +130,7 @@ namespace Consumer
 				{
 					state.impossible_to_solve = true;
 				}
-
-				return false;
-			});
+			}
 
 			state.num_single_left = length;
 		}
@@ -173,9 +175,9 @@ namespace Consumer
 		{
 		}
 
-		ProblemSet result(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, Graph const &graph, Graph_Edits const &edited, Options::Tag::Selector)
+		ProblemSet<VertexID> result(State& state, const Subgraph_Stats_type& subgraph_stats, size_t k, Graph const &graph, Graph_Edits const &edited, Options::Tag::Selector)
 		{
-			ProblemSet problem;
+			ProblemSet<VertexID> problem;
 			problem.found_solution = (subgraph_stats.num_subgraphs == 0);
 			problem.needs_no_edit_branch = false;
 			if (!problem.found_solution && k > 0 && !state.impossible_to_solve) {
@@ -197,19 +199,19 @@ namespace Consumer
 					}
 				}
 
-				size_t max_subgraphs = 0;
+				// all pairs in the most subgraphs, or just the first one if no pair is in more than one
+				const size_t max_subgraphs = subgraph_stats.num_subgraphs_per_edge.max();
 				std::vector<std::pair<VertexID, VertexID>> node_pairs;
-				subgraph_stats.num_subgraphs_per_edge.forAllNodePairs([&](VertexID u, VertexID v, size_t num_fbs) {
-					if (num_fbs > max_subgraphs)
-					{
-						max_subgraphs = num_fbs;
-						node_pairs.clear();
-					}
-					if (num_fbs == max_subgraphs && (num_fbs > 1 || node_pairs.empty()))
-					{
+				if (max_subgraphs > 1)
+				{
+					subgraph_stats.num_subgraphs_per_edge.forAllNodePairsWithValue(max_subgraphs, [&](VertexID u, VertexID v) {
 						node_pairs.emplace_back(u, v);
-					}
-				});
+					});
+				}
+				else
+				{
+					node_pairs.push_back(subgraph_stats.num_subgraphs_per_edge.firstNodePairWithValue(max_subgraphs));
+				}
 
 				std::vector<forbidden_count> best_pairs, current_pairs;
 				for (std::pair<VertexID, VertexID> node_pair : node_pairs)
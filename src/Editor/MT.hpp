@@ -8,11 +8,13 @@
 #include <iostream>
 #include <numeric>
 
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <functional>
 #include <map>
 #include <mutex>
+#include <random>
 #include <thread>
 #include <typeinfo>
 #include <utility>
@@ -26,6 +28,7 @@
 #include "../Finder/Finder.hpp"
 #include "../LowerBound/Lower_Bound.hpp"
 #include "../ProblemSet.hpp"
+#include "../Work_Stealing_Deque.hpp"
 #include "../Finder/SubgraphStats.hpp"
 
 namespace Editor
@@ -35,6 +38,7 @@ namespace Editor
 	{
 	public:
 		static constexpr char const *name = "MT";
+		using VertexID = typename Graph::VertexID;
 		static_assert(Consumer_valid<Consumer...>::value, "Missing Selector and/or Lower_Bound");
 
 		static constexpr size_t selector = Options::get_tagged_consumer<Options::Tag::Selector, Consumer...>::value;
@@ -43,34 +47,52 @@ namespace Editor
 		using Lower_Bound_type = typename std::tuple_element<lb, std::tuple<Consumer ...>>::type;
 		using Lower_Bound_Storage_type = ::Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, Finder::length>;
 		using State_Tuple_type = std::tuple<typename Consumer::State...>;
+		using ProblemSet_type = ProblemSet<VertexID>;
 		using Subgraph_Stats_type = ::Finder::Subgraph_Stats<Finder, Graph, Graph_Edits, Mode, Restriction, Conversion, Finder::length>;
 		static constexpr bool stats_simple = true;
 
 	private:
-		static constexpr bool needs_subgraph_stats = (Consumer::needs_subgraph_stats || ...);
+		static constexpr bool needs_subgraph_index = (Consumer::needs_subgraph_index || ...);
+		/* the subgraph index is part of the subgraph stats */
+		static constexpr bool needs_subgraph_stats = (Consumer::needs_subgraph_stats || ...) || needs_subgraph_index;
+		static constexpr bool needs_edit_delta = needs_subgraph_stats || (Consumer::needs_edit_delta || ...);
+		using Edit_Delta = ::Finder::Edit_Delta<VertexID, Finder::length>;
+
+		/** A single change on the way from the initial graph to the graph of a work package */
+		struct Step
+		{
+			VertexID u, v;
+			/* mark (u, v) as edited, otherwise toggle the edge (u, v) */
+			bool mark;
+		};
 
+		/** Work packages only store the steps leading to their graph, workers replay them onto their own copy of the initial graph */
 		struct Work
 		{
-			Graph graph;
-			Graph_Edits edited;
+			std::vector<Step> steps;
 			size_t k;
 			State_Tuple_type state;
-			Subgraph_Stats_type subgraph_stats;
 			bool initial_bound;
 
-			Work(Graph graph, Graph_Edits edited, size_t k, State_Tuple_type state, Subgraph_Stats_type subgraph_stats, bool initial_bound = true) : graph(std::move(graph)), edited(std::move(edited)), k(k), state(std::move(state)), subgraph_stats(std::move(subgraph_stats)), initial_bound(initial_bound) {;}
+			Work(std::vector<Step> steps, size_t k, State_Tuple_type state, bool initial_bound = true) : steps(std::move(steps)), k(k), state(std::move(state)), initial_bound(initial_bound) {;}
 		};
 
 		Finder &finder;
 		std::tuple<Consumer &...> consumer;
 		const Graph &graph;
 
-		std::deque<std::unique_ptr<Work>> available_work;
-		std::mutex work_mutex;
+		/* one deque per worker, the owner pushes and pops at the bottom, idle workers steal the oldest package */
+		std::vector<std::unique_ptr<Work_Stealing_Deque<Work>>> queues;
 		std::mutex write_mutex;
-		size_t working;
-		bool done = false;
+		/* workers holding or trying to steal a package; no package can exist once this drops to 0 */
+		std::atomic<size_t> working;
+		/* workers without a package, including those scanning the deques; packages are split off only while some are idle */
+		std::atomic<size_t> idle;
+		/* workers parked on idlers, producers only notify if there are any */
+		std::atomic<size_t> sleeping;
+		std::mutex idle_mutex;
 		std::condition_variable idlers;
+		std::atomic<bool> done;
 		size_t threads;
 
 		bool found_soulution;
@@ -91,17 +113,24 @@ namespace Editor
 #endif
 
 	public:
-		MT(Finder &finder, const Graph &graph, std::tuple<Consumer &...> consumer, size_t threads) : finder(finder), consumer(consumer), graph(graph), threads(threads), subgraph_stats(needs_subgraph_stats ? graph.size() : 0), initial_edited(graph.size()) {}
+		MT(Finder &finder, const Graph &graph, std::tuple<Consumer &...> consumer, size_t threads) : finder(finder), consumer(consumer), graph(graph), threads(threads), subgraph_stats(needs_subgraph_stats ? graph.size() : 0, needs_subgraph_index), initial_edited(graph.size()) {}
 
 		size_t initialize()
 		{
 
 			size_t kmax = std::numeric_limits<size_t>::max();
-			subgraph_stats.initialize(graph, initial_edited);
+			subgraph_stats.initialize(graph, initial_edited, threads);
 			initial_state = std::make_unique<State_Tuple_type>(Util::for_make_tuple<sizeof...(Consumer)>([&](auto i) {
 				return std::get<i.value>(consumer).initialize(kmax, graph, initial_edited);
 			}));
-			return std::get<lb>(consumer).result(std::get<lb>(*initial_state), subgraph_stats, kmax, graph, initial_edited, Options::Tag::Lower_Bound());
+			if constexpr (std::is_base_of<Options::Tag::Root_Bound, Lower_Bound_type>::value)
+			{
+				return std::get<lb>(consumer).result(std::get<lb>(*initial_state), subgraph_stats, kmax, graph, initial_edited, threads, Options::Tag::Root_Bound());
+			}
+			else
+			{
+				return std::get<lb>(consumer).result(std::get<lb>(*initial_state), subgraph_stats, kmax, graph, initial_edited, Options::Tag::Lower_Bound());
+			}
 		}
 
 		bool edit(size_t k, decltype(write) const &writegraph)
@@ -120,17 +149,25 @@ namespace Editor
 			found_soulution = false;
 			done = false;
 
+			// before the workers copy the consumers
+			Util::for_<sizeof...(Consumer)>([&](auto i){
+				return std::get<i.value>(consumer).set_initial_k(k, graph, initial_edited);
+			});
+
 			std::vector<Worker> workers;
 			workers.reserve(threads);
+			queues.clear();
 			for(size_t i = 0; i < threads; i++)
 			{
-				workers.emplace_back(*this, finder, consumer);
+				workers.emplace_back(*this, finder, consumer, i);
+				queues.push_back(std::make_unique<Work_Stealing_Deque<Work>>());
 			}
 
-			available_work.clear();
-			available_work.push_back(std::make_unique<Work>(graph, initial_edited, k, *initial_state, subgraph_stats, false));
+			queues[0]->push(std::make_unique<Work>(std::vector<Step>(), k, *initial_state, false));
 
 			working = threads;
+			idle = 0;
+			sleeping = 0;
 			std::vector<std::thread> work_threads;
 			for(size_t t = 1; t < threads; t++)
 			{
@@ -138,6 +175,7 @@ namespace Editor
 			}
 			workers[0].edit(k);
 			for(auto &t: work_threads) {t.join();}
+			queues.clear();
 
 #ifdef STATS
 			for(auto &worker: workers)
@@ -165,24 +203,144 @@ namespace Editor
 #endif
 
 	private:
+		/* an idle worker rescans the deques this often before it parks */
+		static constexpr size_t steal_spins = 16;
+
+		/** Stops all workers, including the parked ones */
+		void finish()
+		{
+			std::lock_guard<std::mutex> lock(idle_mutex);
+			done = true;
+			idlers.notify_all();
+		}
+
+		/** Wakes the parked workers after packages were pushed */
+		void notify_idlers()
+		{
+			// pairs with the fence in park(): either the parked worker sees the package or we see it sleeping
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(sleeping.load(std::memory_order_relaxed) > 0)
+			{
+				std::lock_guard<std::mutex> lock(idle_mutex);
+				idlers.notify_all();
+			}
+		}
+
+		/** Blocks an idle worker until a package may have been pushed or all work is done */
+		void park()
+		{
+			std::unique_lock<std::mutex> lock(idle_mutex);
+			sleeping++;
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			bool available = std::any_of(queues.begin(), queues.end(), [](auto const &queue) {return queue->size() > 0;});
+			if(!done && !available) {idlers.wait(lock);}
+			sleeping--;
+		}
+
 		class Worker
 		{
 		private:
 			MT &editor;
+			size_t id;
+			std::minstd_rand victims;
 			Finder finder;
 			std::tuple<Consumer ...> consumer;
-			std::unique_ptr<Graph> top_graph, bottom_graph;
-			std::unique_ptr<Graph_Edits> top_edited, bottom_edited;
-			Subgraph_Stats_type top_subgraph_stats, bottom_subgraph_stats;
+
+			/** Graph, edits and subgraph stats changed only by logged steps, so they can be reverted to the initial graph */
+			struct Instance
+			{
+				Graph graph;
+				Graph_Edits edited;
+				Subgraph_Stats_type subgraph_stats;
+				std::vector<Step> steps;
+
+				Instance(MT const &editor) : graph(editor.graph), edited(editor.initial_edited), subgraph_stats(editor.subgraph_stats) {;}
+
+				void mark(VertexID u, VertexID v)
+				{
+					edited.set_edge(u, v);
+					subgraph_stats.after_mark(graph, edited, u, v);
+					steps.push_back({u, v, true});
+				}
+
+				/** Undoes the last step, which must be marking (u, v) */
+				void unmark(VertexID u, VertexID v)
+				{
+					assert(!steps.empty() && steps.back().mark && steps.back().u == u && steps.back().v == v);
+					steps.pop_back();
+					edited.clear_edge(u, v);
+					subgraph_stats.after_unmark(graph, edited, u, v);
+				}
+
+				void toggle(VertexID u, VertexID v)
+				{
+					subgraph_stats.before_edit(graph, edited, u, v);
+					graph.toggle_edge(u, v);
+					subgraph_stats.after_edit(graph, edited, u, v);
+					steps.push_back({u, v, false});
+				}
+
+				/** Same as toggle, with the subgraphs containing (u, v) before and after the edit already enumerated */
+				void toggle(VertexID u, VertexID v, Edit_Delta const &delta)
+				{
+					subgraph_stats.before_edit(graph, edited, u, v, delta.destroyed);
+					graph.toggle_edge(u, v);
+					subgraph_stats.after_edit(graph, edited, u, v, delta.created);
+					steps.push_back({u, v, false});
+				}
+
+				/** Undoes the last step, which must be toggling (u, v) */
+				void untoggle(VertexID u, VertexID v)
+				{
+					assert(!steps.empty() && !steps.back().mark && steps.back().u == u && steps.back().v == v);
+					steps.pop_back();
+					subgraph_stats.before_undo_edit(graph, edited, u, v);
+					graph.toggle_edge(u, v);
+					subgraph_stats.after_undo_edit(graph, edited, u, v);
+				}
+
+				/** Undoes toggle(u, v, delta) */
+				void untoggle(VertexID u, VertexID v, Edit_Delta const &delta)
+				{
+					assert(!steps.empty() && !steps.back().mark && steps.back().u == u && steps.back().v == v);
+					steps.pop_back();
+					subgraph_stats.before_undo_edit(graph, edited, u, v, delta.created);
+					graph.toggle_edge(u, v);
+					subgraph_stats.after_undo_edit(graph, edited, u, v, delta.destroyed);
+				}
+
+				void replay(std::vector<Step> const &work_steps)
+				{
+					for(Step const &step: work_steps)
+					{
+						if(step.mark) {mark(step.u, step.v);}
+						else {toggle(step.u, step.v);}
+					}
+				}
+
+				/** Back to the initial graph, in exactly the reverse order so that the subgraph stats can restore counts of unmarked pairs */
+				void revert()
+				{
+					while(!steps.empty())
+					{
+						Step step = steps.back();
+						if(step.mark) {unmark(step.u, step.v);}
+						else {untoggle(step.u, step.v);}
+					}
+				}
+			};
+			std::unique_ptr<Instance> top, bottom;
 			size_t top_k;
 
 			struct Path
 			{
-				ProblemSet problem;
+				ProblemSet_type problem;
 				std::vector<State_Tuple_type> states;
+				/* subgraphs destroyed and created by editing each vertex pair, shared by the consumers and the subgraph stats */
+				std::vector<Edit_Delta> deltas;
 				size_t edges_done = 0;
 
-				Path(ProblemSet problem) : problem(std::move(problem)) {;}
+				Path(ProblemSet_type problem) : problem(std::move(problem)) {;}
 			};
 			std::deque<Path> path;
 		public:
@@ -196,7 +354,7 @@ namespace Editor
 			std::vector<size_t> skipped;
 #endif
 
-			Worker(MT &editor, Finder const &finder, std::tuple<Consumer ...> const &consumer) : editor(editor), finder(finder), consumer(consumer), top_subgraph_stats(0), bottom_subgraph_stats(0) {}
+			Worker(MT &editor, Finder const &finder, std::tuple<Consumer ...> const &consumer, size_t id) : editor(editor), id(id), victims(id + 1), finder(finder), consumer(consumer) {}
 
 			std::map<std::string, std::vector<size_t> const &> stats() const
 			{
@@ -223,191 +381,178 @@ namespace Editor
 				stolen = decltype(stolen)(num_levels, 0);
 				skipped = decltype(skipped)(num_levels, 0);
 #endif
+				// the only full copies of the graph a worker makes
+				top = std::make_unique<Instance>(editor);
+				bottom = std::make_unique<Instance>(editor);
+
 				while(true)
 				{
-					std::unique_lock<std::mutex> lock(editor.work_mutex);
-					std::unique_ptr<Work> work;
-//					std::cout << std::this_thread::get_id() << " needs work" << std::endl;
-					editor.working--;
-					while(true)
+					std::unique_ptr<Work> work = editor.queues[id]->pop();
+					if(!work)
 					{
-						if(editor.done)
-						{
-//							std::cout << std::this_thread::get_id() << " other done" << std::endl;
-							return;
-						}
-						else if(!editor.available_work.empty())
-						{
-							work = std::move(editor.available_work.front());
-							editor.available_work.pop_front();
-							//finder.recalculate();
+						work = steal();
+						if(!work) {return;}
 #ifdef STATS
-							stolen[stats_simple ? 0 : work->k]++;
+						stolen[stats_simple ? 0 : work->k]++;
 #endif
-							break;
-						}
-						else if(editor.working == 0)
-						{
-							/* all threads are waiting for work -> we are done */
-//							std::cout << std::this_thread::get_id() << " detect done" << std::endl;
-							editor.done = true;
-							editor.idlers.notify_all();
-							return;
-						}
-						else
-						{
-//							std::cout << std::this_thread::get_id() << " idle" << std::endl;
-							editor.idlers.wait(lock);
-//							std::cout << std::this_thread::get_id() << " notified" << std::endl;
-						}
 					}
-					editor.working++;
-//					std::cout << std::this_thread::get_id() << " got work" << std::endl;
-					lock.unlock();
-
-					top_graph = std::make_unique<Graph>(work->graph);
-					bottom_graph = std::make_unique<Graph>(std::move(work->graph));
-					top_edited = std::make_unique<Graph>(work->edited);
-					bottom_edited = std::make_unique<Graph>(std::move(work->edited));
-					top_subgraph_stats = work->subgraph_stats;
-					bottom_subgraph_stats = std::move(work->subgraph_stats);
+
+					top->replay(work->steps);
+					bottom->replay(work->steps);
 					top_k = work->k;
 					if(edit_rec(work->k, std::move(work->state), work->initial_bound))
 					{
-						editor.done = true;
-						editor.idlers.notify_all();
+						editor.finish();
 						return;
 					}
 
 					path.clear();
+					top->revert();
+					bottom->revert();
 				}
 			}
 
-			void generate_work_packages()
+			/** Waits until a package can be stolen from another worker, returns nullptr once all work is done.
+			 * After steal_spins failed scans the worker parks until a package is pushed.
+			 */
+			std::unique_ptr<Work> steal()
 			{
-				if(!path.empty() && editor.available_work.size() < editor.threads)
+				editor.idle++;
+				// announce the attempt first so that a package in transit keeps working above 0
+				editor.working--;
+				for(size_t attempt = 0; !editor.done; attempt++)
 				{
-					// skip sharing if some other thread already does
-					std::unique_lock<std::mutex> lock(editor.work_mutex, std::try_to_lock);
-					if(lock)
+					editor.working++;
+					size_t first = victims() % editor.threads;
+					for(size_t i = 0; i < editor.threads; i++)
 					{
-						while (!path.empty() && editor.available_work.size() < editor.threads * 2)
+						size_t victim = (first + i) % editor.threads;
+						if(victim == id) {continue;}
+						if(std::unique_ptr<Work> work = editor.queues[victim]->steal())
 						{
-							// add new work to queue
-							// take top problem and split (same logic as below, but no recursion)
-							// update top
-
-							const ProblemSet &problem = path.front().problem;
-							const size_t &edges_done = path.front().edges_done;
+							editor.idle--;
+							return work;
+						}
+					}
+					if(--editor.working == 0)
+					{
+						/* nobody holds a package and all deques are empty -> we are done */
+						editor.finish();
+						break;
+					}
+					if(attempt < steal_spins) {std::this_thread::yield();}
+					else {editor.park();}
+				}
+				editor.idle--;
+				return nullptr;
+			}
 
-							// For non-redundant editing, we need to mark all node pairs as edited whose
-							// branches were already processed.
-							if constexpr (std::is_same<Restriction, Options::Restrictions::Redundant>::value)
-							{
-								for (size_t i = 0; i < edges_done && i < problem.vertex_pairs.size(); ++i)
-								{
-									auto [u,v,lb] = problem.vertex_pairs[i];
-									assert(!top_edited->has_edge(u, v));
-									top_edited->set_edge(u, v);
-									top_subgraph_stats.after_mark(*top_graph, *top_edited, u, v);
-								}
-							}
+			void generate_work_packages()
+			{
+				// only split while others are idle, the oldest packages are stolen first
+				size_t idle = editor.idle.load(std::memory_order_relaxed);
+				Work_Stealing_Deque<Work> &queue = *editor.queues[id];
+				if(!path.empty() && idle > 0 && queue.size() < idle)
+				{
+					while (!path.empty() && queue.size() < 2 * idle)
+					{
+						// add new work to queue
+						// take top problem and split (same logic as below, but no recursion)
+						// update top
 
+						const ProblemSet_type &problem = path.front().problem;
+						const size_t &edges_done = path.front().edges_done;
 
-							// For all node pairs after the current node pair, create a work package for editing
-							// the node pairs.
-							for (size_t i = edges_done; i < problem.vertex_pairs.size(); ++i)
+						// For non-redundant editing, we need to mark all node pairs as edited whose
+						// branches were already processed.
+						if constexpr (std::is_same<Restriction, Options::Restrictions::Redundant>::value)
+						{
+							for (size_t i = 0; i < edges_done && i < problem.vertex_pairs.size(); ++i)
 							{
 								auto [u,v,lb] = problem.vertex_pairs[i];
-								assert(!top_edited->has_edge(u, v));
-
-
-								// Both for no-undo and for non-redundant, mark the node pair as edited
-								if constexpr (!std::is_same<Restriction, Options::Restrictions::None>::value)
-								{
-									top_edited->set_edge(u, v);
-									top_subgraph_stats.after_mark(*top_graph, *top_edited, u, v);
-								}
-
-								top_subgraph_stats.before_edit(*top_graph, *top_edited, u, v);
+								assert(!top->edited.has_edge(u, v));
+								top->mark(u, v);
+							}
+						}
 
-								// Edit the node pair
-								top_graph->toggle_edge(u, v);
 
-								top_subgraph_stats.after_edit(*top_graph, *top_edited, u, v);
+						// For all node pairs after the current node pair, create a work package for editing
+						// the node pairs.
+						for (size_t i = edges_done; i < problem.vertex_pairs.size(); ++i)
+						{
+							auto [u,v,lb] = problem.vertex_pairs[i];
+							assert(!top->edited.has_edge(u, v));
 
-								// Create work package for recursive call with k-1
-								editor.available_work.push_back(std::make_unique<Work>(*top_graph, *top_edited, top_k - 1, std::move(path.front().states[i]), top_subgraph_stats));
 
-								top_subgraph_stats.before_edit(*top_graph, *top_edited, u, v);
+							// Both for no-undo and for non-redundant, mark the node pair as edited
+							if constexpr (!std::is_same<Restriction, Options::Restrictions::None>::value)
+							{
+								top->mark(u, v);
+							}
 
-								// Undo edit after the recursion
-								top_graph->toggle_edge(u, v);
+							// Edit the node pair
+							top->toggle(u, v);
 
-								top_subgraph_stats.after_edit(*top_graph, *top_edited, u, v);
+							// Create work package for recursive call with k-1
+							queue.push(std::make_unique<Work>(top->steps, top_k - 1, std::move(path.front().states[i])));
 
-								// For no-undo, we directly unmark the node pair
-								if constexpr (std::is_same<Restriction, Options::Restrictions::Undo>::value)
-								{
-									top_edited->clear_edge(u, v);
-									top_subgraph_stats.after_unmark(*top_graph, *top_edited, u, v);
-								}
-							}
+							// Undo edit after the recursion
+							top->untoggle(u, v);
 
-							// For single node pair editing, create an additional work package where no node pair is edited
-							// but with no_edits_left - 1. Note that during the previous two loops, one or several node pairs
-							// were marked as edited.
-							if (problem.needs_no_edit_branch && edges_done <= problem.vertex_pairs.size())
+							// For no-undo, we directly unmark the node pair
+							if constexpr (std::is_same<Restriction, Options::Restrictions::Undo>::value)
 							{
-								editor.available_work.push_back(std::make_unique<Work>(*top_graph, *top_edited, top_k, std::move(path.front().states.back()), top_subgraph_stats));
+								top->unmark(u, v);
 							}
+						}
 
-							/* adjust top for recursion this thread is currently in */
-							assert(edges_done > 0);
+						// For single node pair editing, create an additional work package where no node pair is edited
+						// but with no_edits_left - 1. Note that during the previous two loops, one or several node pairs
+						// were marked as edited.
+						if (problem.needs_no_edit_branch && edges_done <= problem.vertex_pairs.size())
+						{
+							queue.push(std::make_unique<Work>(top->steps, top_k, std::move(path.front().states.back())));
+						}
 
-							// For non-redundant editing, unmark all node pairs after the current node pair
-							if constexpr (std::is_same<Restriction, Options::Restrictions::Redundant>::value)
-							{
-								assert(edges_done > 0);
-								for(size_t i = problem.vertex_pairs.size() - 1; i >= edges_done; --i)
-								{
-									auto [u,v,lb] = problem.vertex_pairs[i];
-									top_edited->clear_edge(u, v);
-									top_subgraph_stats.after_unmark(*top_graph, *top_edited, u, v);
-								}
-							}
+						/* adjust top for recursion this thread is currently in */
+						assert(edges_done > 0);
 
-							if (edges_done <= problem.vertex_pairs.size())
+						// For non-redundant editing, unmark all node pairs after the current node pair
+						if constexpr (std::is_same<Restriction, Options::Restrictions::Redundant>::value)
+						{
+							assert(edges_done > 0);
+							for(size_t i = problem.vertex_pairs.size() - 1; i >= edges_done; --i)
 							{
-								// We are in the recursive call where (u, v) has been edited.
-								auto [u,v,lb] = problem.vertex_pairs[edges_done - 1];
-
-								top_subgraph_stats.before_edit(*top_graph, *top_edited, u, v);
+								auto [u,v,lb] = problem.vertex_pairs[i];
+								top->unmark(u, v);
+							}
+						}
 
-								top_graph->toggle_edge(u, v);
+						if (edges_done <= problem.vertex_pairs.size())
+						{
+							// We are in the recursive call where (u, v) has been edited.
+							auto [u,v,lb] = problem.vertex_pairs[edges_done - 1];
 
-								top_subgraph_stats.after_edit(*top_graph, *top_edited, u, v);
+							top->toggle(u, v);
 
-								--top_k;
+							--top_k;
 
-								// For no-undo we also need to mark (u, v) as edited.
-								// Note that for non-redundant editing, all node pairs are currently marked as edited.
-								if(std::is_same<Restriction, Options::Restrictions::Undo>::value)
-								{
-									top_edited->set_edge(u, v);
-									top_subgraph_stats.after_mark(*top_graph, *top_edited, u, v);
-								}
-							}
-							else
+							// For no-undo we also need to mark (u, v) as edited.
+							// Note that for non-redundant editing, all node pairs are currently marked as edited.
+							if(std::is_same<Restriction, Options::Restrictions::Undo>::value)
 							{
-								// We are in the no-edit-branch
-								assert(problem.needs_no_edit_branch);
+								top->mark(u, v);
 							}
-
-							editor.idlers.notify_all();
-							path.pop_front();
 						}
+						else
+						{
+							// We are in the no-edit-branch
+							assert(problem.needs_no_edit_branch);
+						}
+
+						path.pop_front();
 					}
+					editor.notify_idlers();
 				}
 			}
 
@@ -422,7 +567,7 @@ namespace Editor
 				calls[stat_level]++;
 #endif
 				{
-					if (initial_bound && k < std::get<lb>(consumer).result(std::get<lb>(initial_state), bottom_subgraph_stats, k, *bottom_graph, *bottom_edited, Options::Tag::Lower_Bound()))
+					if (initial_bound && k < std::get<lb>(consumer).result(std::get<lb>(initial_state), bottom->subgraph_stats, k, bottom->graph, bottom->edited, Options::Tag::Lower_Bound()))
 					{
 						// lower bound too high
 #ifdef STATS
@@ -432,12 +577,12 @@ namespace Editor
 					}
 
 					// graph solved?
-					ProblemSet problem = std::get<selector>(consumer).result(std::get<selector>(initial_state), bottom_subgraph_stats, k, *bottom_graph, *bottom_edited, Options::Tag::Selector());
+					ProblemSet_type problem = std::get<selector>(consumer).result(std::get<selector>(initial_state), bottom->subgraph_stats, k, bottom->graph, bottom->edited, Options::Tag::Selector());
 					if(problem.found_solution)
 					{
 						std::unique_lock<std::mutex> ul(editor.write_mutex);
 						editor.found_soulution = true;
-						return !editor.write(*bottom_graph, *bottom_edited);
+						return !editor.write(bottom->graph, bottom->edited);
 					}
 					else if(k == 0)
 					{
@@ -466,13 +611,15 @@ namespace Editor
 
 				// Prune branches by using extra lower bounds
 				{
-					ProblemSet &problem = path.back().problem;
+					ProblemSet_type &problem = path.back().problem;
 					std::vector<State_Tuple_type> &states = path.back().states;
+					std::vector<Edit_Delta> &deltas = path.back().deltas;
+					deltas.reserve(problem.vertex_pairs.size());
 
 					for (size_t i = 0; i < problem.vertex_pairs.size(); ++i)
 					{
 						auto [u,v,updateLB] = problem.vertex_pairs[i];
-						assert(!bottom_edited->has_edge(u, v));
+						assert(!bottom->edited.has_edge(u, v));
 
 						// If requested, update the lower bound before considering node pair i
 						if (updateLB)
@@ -481,7 +628,7 @@ namespace Editor
 							++calls[stat_level];
 							++extra_lbs[stat_level];
 #endif
-							if (k < std::get<lb>(consumer).result(std::get<lb>(states.back()), bottom_subgraph_stats, k, *bottom_graph, *bottom_edited, Options::Tag::Lower_Bound()))
+							if (k < std::get<lb>(consumer).result(std::get<lb>(states.back()), bottom->subgraph_stats, k, bottom->graph, bottom->edited, Options::Tag::Lower_Bound()))
 							{
 								// The lower bound is to high, we do not need to consider node pair i or any later node pair - remove them from the problem!
 								problem.vertex_pairs.erase(problem.vertex_pairs.begin() + i, problem.vertex_pairs.end());
@@ -500,27 +647,32 @@ namespace Editor
 						// Prepare the state for the recursive call where the ndoe pair is edited.
 						Util::for_<sizeof...(Consumer)>([&, u = u, v = v](auto i)
 						{
-							std::get<i.value>(consumer).before_mark_and_edit(std::get<i.value>(states.back()), *bottom_graph, *bottom_edited, u, v);
+							std::get<i.value>(consumer).before_mark_and_edit(std::get<i.value>(states.back()), bottom->graph, bottom->edited, u, v);
 						});
 
 						if constexpr (!std::is_same<Restriction, Options::Restrictions::None>::value)
 						{
-							bottom_edited->set_edge(u, v);
+							bottom->edited.set_edge(u, v);
 						}
 
-						bottom_graph->toggle_edge(u, v);
+						Edit_Delta &delta = deltas.emplace_back();
+						if constexpr (needs_edit_delta) {Edit_Delta::find(finder, bottom->graph, u, v, delta.destroyed);}
+
+						bottom->graph.toggle_edge(u, v);
+
+						if constexpr (needs_edit_delta) {Edit_Delta::find(finder, bottom->graph, u, v, delta.created);}
 
 						Util::for_<sizeof...(Consumer)>([&, u = u, v = v](auto i)
 						{
-							std::get<i.value>(consumer).after_mark_and_edit(std::get<i.value>(states.back()), *bottom_graph, *bottom_edited, u, v);
+							std::get<i.value>(consumer).after_mark_and_edit(std::get<i.value>(states.back()), bottom->graph, bottom->edited, u, v, delta);
 						});
 
 						// Reset the state again.
-						bottom_graph->toggle_edge(u, v);
+						bottom->graph.toggle_edge(u, v);
 
 						if constexpr (!std::is_same<Restriction, Options::Restrictions::None>::value)
 						{
-							bottom_edited->clear_edge(u, v);
+							bottom->edited.clear_edge(u, v);
 						}
 
 						if (!next_state) break;
@@ -531,16 +683,14 @@ namespace Editor
 						{
 							Util::for_<sizeof...(Consumer)>([&, u = u, v = v](auto i)
 							{
-								std::get<i.value>(consumer).before_mark(std::get<i.value>(*next_state), *bottom_graph, *bottom_edited, u, v);
+								std::get<i.value>(consumer).before_mark(std::get<i.value>(*next_state), bottom->graph, bottom->edited, u, v);
 							});
 
-							bottom_edited->set_edge(u, v);
-
-							bottom_subgraph_stats.after_mark(*bottom_graph, *bottom_edited, u, v);
+							bottom->mark(u, v);
 
 							Util::for_<sizeof...(Consumer)>([&, u = u, v = v](auto i)
 							{
-								std::get<i.value>(consumer).after_mark(std::get<i.value>(*next_state), *bottom_graph, *bottom_edited, u, v);
+								std::get<i.value>(consumer).after_mark(std::get<i.value>(*next_state), bottom->graph, bottom->edited, u, v);
 							});
 						}
 
@@ -552,10 +702,9 @@ namespace Editor
 					{
 						for (auto it = problem.vertex_pairs.rbegin(); it != problem.vertex_pairs.rend(); ++it)
 						{
-							if (bottom_edited->has_edge(it->first, it->second))
+							if (bottom->edited.has_edge(it->first, it->second))
 							{
-								bottom_edited->clear_edge(it->first, it->second);
-								bottom_subgraph_stats.after_unmark(*bottom_graph, *bottom_edited, it->first, it->second);
+								bottom->unmark(it->first, it->second);
 							}
 						}
 					}
@@ -566,22 +715,17 @@ namespace Editor
 				{
 					auto [u,v,lb] = path.back().problem.vertex_pairs[i];
 
-					if(bottom_edited->has_edge(u, v))
+					if(bottom->edited.has_edge(u, v))
 					{
 						abort();
 					}
 
 					if constexpr (!std::is_same<Restriction, Options::Restrictions::None>::value)
 					{
-						bottom_edited->set_edge(u, v);
-						bottom_subgraph_stats.after_mark(*bottom_graph, *bottom_edited, u, v);
+						bottom->mark(u, v);
 					}
 
-					bottom_subgraph_stats.before_edit(*bottom_graph, *bottom_edited, u, v);
-
-					bottom_graph->toggle_edge(u, v);
-
-					bottom_subgraph_stats.after_edit(*bottom_graph, *bottom_edited, u, v);
+					bottom->toggle(u, v, path.back().deltas[i]);
 
 					path.back().edges_done++;
 
@@ -589,16 +733,11 @@ namespace Editor
 					// The path might be empty now if work has been stolen.
 					else if(path.empty()) {return false;}
 
-					bottom_subgraph_stats.before_edit(*bottom_graph, *bottom_edited, u, v);
-
-					bottom_graph->toggle_edge(u, v);
-
-					bottom_subgraph_stats.after_edit(*bottom_graph, *bottom_edited, u, v);
+					bottom->untoggle(u, v, path.back().deltas[i]);
 
 					if constexpr (std::is_same<Restriction, Options::Restrictions::Undo>::value)
 					{
-						bottom_edited->clear_edge(u, v);
-						bottom_subgraph_stats.after_unmark(*bottom_graph, *bottom_edited, u, v);
+						bottom->unmark(u, v);
 					}
 				}
 
@@ -619,10 +758,9 @@ namespace Editor
 				{
 					for (auto it = path.back().problem.vertex_pairs.rbegin(); it != path.back().problem.vertex_pairs.rend(); ++it)
 					{
-						if (bottom_edited->has_edge(it->first, it->second))
+						if (bottom->edited.has_edge(it->first, it->second))
 						{
-							bottom_edited->clear_edge(it->first, it->second);
-							bottom_subgraph_stats.after_unmark(*bottom_graph, *bottom_edited, it->first, it->second);
+							bottom->unmark(it->first, it->second);
 						}
 					}
 				}
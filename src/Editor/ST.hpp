@@ -26,6 +26,7 @@ namespace Editor
 	{
 	public:
 		static constexpr char const *name = "ST";
+		using VertexID = typename Graph::VertexID;
 		static_assert(Consumer_valid<Consumer...>::value, "Missing Selector and/or Lower_Bound");
 
 		static constexpr size_t selector = Options::get_tagged_consumer<Options::Tag::Selector, Consumer...>::value;
@@ -35,6 +36,7 @@ namespace Editor
 		using Lower_Bound_Storage_type = Lower_Bound::Lower_Bound<Mode, Restriction, Conversion, Graph, Graph_Edits, Finder::length>;
 
 		using State_Tuple_type = std::tuple<typename Consumer::State...>;
+		using ProblemSet_type = ProblemSet<VertexID>;
 		static constexpr bool stats_simple = true;
 
 	private:
@@ -42,11 +44,17 @@ namespace Editor
 		std::tuple<Consumer &...> consumer;
 		Graph &graph;
 		Graph_Edits edited;
+		/* the search is sequential, only the initialization uses more threads */
+		size_t threads;
 		std::unique_ptr<State_Tuple_type> initial_state;
 
 		::Finder::Subgraph_Stats<Finder, Graph, Graph_Edits, Mode, Restriction, Conversion, Finder::length> subgraph_stats;
 
-		static constexpr bool needs_subgraph_stats = (Consumer::needs_subgraph_stats || ...);
+		static constexpr bool needs_subgraph_index = (Consumer::needs_subgraph_index || ...);
+		/* the subgraph index is part of the subgraph stats */
+		static constexpr bool needs_subgraph_stats = (Consumer::needs_subgraph_stats || ...) || needs_subgraph_index;
+		static constexpr bool needs_edit_delta = needs_subgraph_stats || (Consumer::needs_edit_delta || ...);
+		using Edit_Delta = ::Finder::Edit_Delta<VertexID, Finder::length>;
 
 		bool found_solution;
 		std::function<bool(Graph const &, Graph_Edits const &)> write;
@@ -60,20 +68,27 @@ namespace Editor
 #endif
 
 	public:
-		ST(Finder &finder, Graph &graph, std::tuple<Consumer &...> consumer, size_t) : finder(finder), consumer(consumer), graph(graph), edited(graph.size()), subgraph_stats(needs_subgraph_stats ? graph.size() : 0), found_solution(false)
+		ST(Finder &finder, Graph &graph, std::tuple<Consumer &...> consumer, size_t threads) : finder(finder), consumer(consumer), graph(graph), edited(graph.size()), threads(threads), subgraph_stats(needs_subgraph_stats ? graph.size() : 0, needs_subgraph_index), found_solution(false)
 		{
 			;
 		}
 
 		size_t initialize()
 		{
-			subgraph_stats.initialize(graph, edited);
+			subgraph_stats.initialize(graph, edited, threads);
 			size_t max_k = std::numeric_limits<size_t>::max();
 			initial_state = std::make_unique<State_Tuple_type>(Util::for_make_tuple<sizeof...(Consumer)>([&](auto i){
 				return std::get<i.value>(consumer).initialize(max_k, graph, edited);
 			}));
 
-			return std::get<lb>(consumer).result(std::get<lb>(*initial_state), subgraph_stats, max_k, graph, edited, Options::Tag::Lower_Bound());
+			if constexpr (std::is_base_of<Options::Tag::Root_Bound, Lower_Bound_type>::value)
+			{
+				return std::get<lb>(consumer).result(std::get<lb>(*initial_state), subgraph_stats, max_k, graph, edited, threads, Options::Tag::Root_Bound());
+			}
+			else
+			{
+				return std::get<lb>(consumer).result(std::get<lb>(*initial_state), subgraph_stats, max_k, graph, edited, Options::Tag::Lower_Bound());
+			}
 		}
 
 		bool edit(size_t k, decltype(write) const &writegraph)
@@ -121,7 +136,7 @@ namespace Editor
 			}
 
 			// graph solved?
-			ProblemSet problem = std::get<selector>(consumer).result(std::get<selector>(state), subgraph_stats, k, graph, edited, Options::Tag::Selector());
+			ProblemSet_type problem = std::get<selector>(consumer).result(std::get<selector>(state), subgraph_stats, k, graph, edited, Options::Tag::Selector());
 
 			if(problem.found_solution)
 			{
@@ -139,7 +154,7 @@ namespace Editor
 
 			bool return_value = false;
 
-			for (ProblemSet::VertexPair vertex_pair : problem.vertex_pairs)
+			for (typename ProblemSet_type::VertexPair vertex_pair : problem.vertex_pairs)
 			{
 				if(edited.has_edge(vertex_pair.first, vertex_pair.second))
 				{
@@ -183,24 +198,30 @@ namespace Editor
 					subgraph_stats.after_mark(graph, edited, vertex_pair.first, vertex_pair.second);
 				}
 
-				subgraph_stats.before_edit(graph, edited, vertex_pair.first, vertex_pair.second);
+				// enumerate the subgraphs containing the pair once for the subgraph stats and all consumers, both for the edit and its undo
+				Edit_Delta delta;
+				if constexpr (needs_edit_delta) {Edit_Delta::find(finder, graph, vertex_pair.first, vertex_pair.second, delta.destroyed);}
+
+				subgraph_stats.before_edit(graph, edited, vertex_pair.first, vertex_pair.second, delta.destroyed);
 
 				graph.toggle_edge(vertex_pair.first, vertex_pair.second);
 
+				if constexpr (needs_edit_delta) {Edit_Delta::find(finder, graph, vertex_pair.first, vertex_pair.second, delta.created);}
+
 				Util::for_<sizeof...(Consumer)>([&](auto i)
 				{
-					std::get<i.value>(consumer).after_mark_and_edit(std::get<i.value>(next_state), graph, edited, vertex_pair.first, vertex_pair.second);
+					std::get<i.value>(consumer).after_mark_and_edit(std::get<i.value>(next_state), graph, edited, vertex_pair.first, vertex_pair.second, delta);
 				});
 
-				subgraph_stats.after_edit(graph, edited, vertex_pair.first, vertex_pair.second);
+				subgraph_stats.after_edit(graph, edited, vertex_pair.first, vertex_pair.second, delta.created);
 
 				if(edit_rec(k - 1, std::move(next_state))) {return_value = true;}
 
-				subgraph_stats.before_edit(graph, edited, vertex_pair.first, vertex_pair.second);
+				subgraph_stats.before_undo_edit(graph, edited, vertex_pair.first, vertex_pair.second, delta.created);
 
 				graph.toggle_edge(vertex_pair.first, vertex_pair.second);
 
-				subgraph_stats.after_edit(graph, edited, vertex_pair.first, vertex_pair.second);
+				subgraph_stats.after_undo_edit(graph, edited, vertex_pair.first, vertex_pair.second, delta.destroyed);
 
 				Util::for_<sizeof...(Consumer)>([&](auto i)
 				{
@@ -3,12 +3,19 @@
 
 #include <assert.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "../config.hpp"
 #include "../Options.hpp"
 #include "../util.hpp"
 
+#include "../Graph/Row_Kernels.hpp"
+
 namespace Finder
 {
 	template<typename Graph, typename Graph_Edits, typename _Mode, typename _Restriction, typename _Conversion, size_t _length, bool _with_cycles>
@@ -18,9 +25,14 @@ namespace Finder
 		static constexpr char const *name = "Center";
 		static constexpr size_t length = _length;
 		static constexpr bool with_cycles = _with_cycles;
+		/* each cycle is listed once, closed by its canonical pair. With Skip, the listings of a cycle skip different pairs, so all length of them are kept */
+		static constexpr bool unique_cycles = _with_cycles && !std::is_same<_Conversion, Options::Conversions::Skip>::value;
+		/* count() is available */
+		static constexpr bool can_count = (_length == 4);
 		using Mode = _Mode;
 		using Restriction = _Restriction;
 		using Conversion = _Conversion;
+		using VertexID = typename Graph::VertexID;
 
 		static_assert(_length > 1, "Can only detect path/cycles with at least 2 vertices");
 		static_assert(_length > 3 || !_with_cycles, "Cycles are only supported with length at least 4");
@@ -28,6 +40,66 @@ namespace Finder
 
 	private:
 		std::vector<Packed> forbidden;
+
+		/** Adjacency rows as seen by the search */
+		class Rows
+		{
+		private:
+			Graph const &graph;
+
+		public:
+			Rows(Graph const &graph) : graph(graph) {;}
+
+			Packed neighbors(VertexID u, size_t i) const {return graph.get_row(u)[i];}
+			Packed non_neighbors(VertexID u, size_t i) const {return ~graph.get_row(u)[i];}
+
+			/** dst = ~non_neighbors(u) */
+			void copy_excluded(Packed *dst, VertexID u) const
+			{
+				Packed const *row = graph.get_row(u);
+				std::copy(row, row + graph.get_row_length(), dst);
+			}
+
+			/** dst = f | ~non_neighbors(u) */
+			void add_excluded(Packed *dst, Packed const *f, VertexID u) const
+			{
+				::Graph::Row::or_rows(dst, f, graph.get_row(u), graph.get_row_length());
+			}
+		};
+
+		/** Adjacency rows without the pairs in forbidden_pairs, these are neither neighbors nor non-neighbors */
+		class Masked_Rows
+		{
+		private:
+			Graph const &graph;
+			Graph_Edits const &forbidden_pairs;
+
+		public:
+			Masked_Rows(Graph const &graph, Graph_Edits const &forbidden_pairs) : graph(graph), forbidden_pairs(forbidden_pairs) {;}
+
+			Packed neighbors(VertexID u, size_t i) const {return graph.get_row(u)[i] & ~forbidden_pairs.get_row(u)[i];}
+			Packed non_neighbors(VertexID u, size_t i) const {return ~graph.get_row(u)[i] & ~forbidden_pairs.get_row(u)[i];}
+
+			void copy_excluded(Packed *dst, VertexID u) const
+			{
+				::Graph::Row::or_rows(dst, graph.get_row(u), forbidden_pairs.get_row(u), graph.get_row_length());
+			}
+
+			void add_excluded(Packed *dst, Packed const *f, VertexID u) const
+			{
+				::Graph::Row::or_rows(dst, f, graph.get_row(u), graph.get_row_length());
+				::Graph::Row::or_rows(dst, dst, forbidden_pairs.get_row(u), graph.get_row_length());
+			}
+		};
+
+		/** Is the cycle @a path closed by its canonical pair, i.e. the pair of its smallest vertex and the smaller of that vertex's two neighbors in the cycle? */
+		static bool closed_canonically(std::array<VertexID, length> const &path)
+		{
+			const size_t j = std::min_element(path.begin(), path.end()) - path.begin();
+			const VertexID partner = std::min(path[(j + 1) % length], path[(j + length - 1) % length]);
+			return (j == 0 && path.back() == partner) || (j == length - 1 && path.front() == partner);
+		}
+
 	public:
 		Center(VertexID graph_size) : forbidden(Graph::alloc_rows(graph_size, length)) {;}
 
@@ -68,44 +140,130 @@ namespace Finder
 		template <typename F>
 		void find(Graph const &graph, F callback)
 		{
-			auto get_neighbors = [&graph](VertexID u, size_t i) { return graph.get_row(u)[i]; };
-			auto get_non_neighbors = [&graph](VertexID u, size_t i) { return ~graph.get_row(u)[i]; };
-
-			find(graph, callback, get_neighbors, get_non_neighbors);
+			Rows rows(graph);
+			find_rows(graph, callback, rows);
 		}
 
 		template<typename F>
-		void find(Graph const &graph, F callback, Graph_Edits &forbidden_pairs)
+		void find(Graph const &graph, F callback, Graph_Edits const &forbidden_pairs)
 		{
+			Masked_Rows rows(graph, forbidden_pairs);
+			find_rows(graph, callback, rows);
+		}
 
-			auto get_neighbors = [&graph, &forbidden_pairs](VertexID u, size_t i) { return graph.get_row(u)[i] & ~forbidden_pairs.get_row(u)[i]; };
-			auto get_non_neighbors = [&graph, &forbidden_pairs](VertexID u, size_t i) { return ~graph.get_row(u)[i] & ~forbidden_pairs.get_row(u)[i]; };
 
-			find(graph, callback, get_neighbors, get_non_neighbors);
+		template <typename F, typename R>
+		void find_rows(Graph const &graph, F callback, R const &rows)
+		{
+			find_range(graph, callback, rows, forbidden, 0, graph.size());
 		}
 
+		/**
+		 * Lists the same subgraphs as find(), in the same order.
+		 * The outer loop over the first vertex is split into blocks that are searched by up to @a threads threads, each with its own exclusion rows.
+		 * The subgraphs of each block are buffered and passed to @a callback on the calling thread once all blocks before it are done, so callback needs no synchronization.
+		 * At most 2 * threads blocks are searched or buffered at any time, so the searchers do not run ahead of callback and buffer most of the subgraphs.
+		 * If callback returns true, the remaining blocks are abandoned.
+		 */
+		template <typename F>
+		void find_parallel(Graph const &graph, size_t threads, F callback)
+		{
+			if (!Graph::concurrent_reads || threads <= 1 || graph.size() < 2 * threads)
+			{
+				find(graph, callback);
+				return;
+			}
+
+			using subgraph_t = std::array<VertexID, length>;
+			// more blocks than threads, the blocks of the first vertices contain more subgraphs for even lengths
+			const size_t num_blocks = std::min<size_t>(graph.size(), 16 * threads);
+			auto block_begin = [&](size_t block) {return static_cast<VertexID>(block * graph.size() / num_blocks);};
+
+			const size_t max_in_flight = 2 * threads;
+
+			std::vector<std::vector<subgraph_t>> found(num_blocks);
+			std::vector<bool> done(num_blocks, false);
+			/* guarded by mutex: the next block to search and the number of blocks passed to callback */
+			size_t next_block = 0, consumed = 0;
+			std::atomic<bool> stop(false);
+			std::mutex mutex;
+			std::condition_variable block_done, block_consumed;
+
+			auto search = [&]()
+			{
+				std::vector<Packed> scratch = Graph::alloc_rows(graph.size(), length);
+				Rows rows(graph);
+				while (true)
+				{
+					size_t block;
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						block_consumed.wait(lock, [&]() {return stop || next_block >= num_blocks || next_block < consumed + max_in_flight;});
+						if (stop || next_block >= num_blocks) {return;}
+						block = next_block++;
+					}
+
+					auto collect = [&](subgraph_t const &path)
+					{
+						found[block].push_back(path);
+						return stop.load(std::memory_order_relaxed);
+					};
+					find_range(graph, collect, rows, scratch, block_begin(block), block_begin(block + 1));
+
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						done[block] = true;
+					}
+					block_done.notify_one();
+				}
+			};
+
+			std::vector<std::thread> searchers;
+			for (size_t t = 0; t < threads; ++t) {searchers.emplace_back(search);}
+
+			for (size_t block = 0; block < num_blocks && !stop; ++block)
+			{
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					block_done.wait(lock, [&]() {return done[block];});
+				}
+				bool stopped = false;
+				for (subgraph_t const &path : found[block])
+				{
+					if (callback(path)) {stopped = true; break;}
+				}
+				std::vector<subgraph_t>().swap(found[block]);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					consumed = block + 1;
+					stop = stop || stopped;
+				}
+				block_consumed.notify_all();
+			}
+
+			for (std::thread &searcher : searchers) {searcher.join();}
+		}
 
-		template <typename F, typename G, typename H>
-		void find(Graph const &graph, F callback, G& get_neighbors, H& get_non_neighbors)
+	private:
+		/** find() restricted to the subgraphs whose first vertex of the outer loop is in [begin, end), using the exclusion rows in scratch */
+		template <typename F, typename R>
+		void find_range(Graph const &graph, F &callback, R const &rows, std::vector<Packed> &scratch, VertexID begin, VertexID end)
 		{
-			assert(forbidden.size() / graph.get_row_length() == length);
+			assert(scratch.size() / graph.get_row_length() == length);
 
 			std::array<VertexID, length> path;
 
 			constexpr bool length_even = (length % 2 == 0);
-			Packed *f = forbidden.data();
+			Packed *f = scratch.data();
 			// Note: if constexpr here avoids instantiation of the wrong recursion with wrong base case
 			if constexpr (!length_even) // uneven length
 			{
-				for(VertexID u = 0; u < graph.size(); u++)
+				for(VertexID u = begin; u < end; u++)
 				{
 					if constexpr (length > 3)
 					{
 						// Mark u and neighbors of u in f
-						for(size_t i = 0; i < graph.get_row_length(); i++)
-						{
-							f[i] = ~get_non_neighbors(u, i);
-						}
+						rows.copy_excluded(f, u);
 						f[u / Packed_Bits] |= Packed(1) << (u % Packed_Bits);
 					}
 					// Store u as central node
@@ -113,7 +271,7 @@ namespace Finder
 					// For all neighbors vf of u
 					for(size_t i = 0; i < graph.get_row_length(); i++)
 					{
-						for(Packed curf = get_neighbors(u, i); curf;)
+						for(Packed curf = rows.neighbors(u, i); curf;)
 						{
 							const VertexID lzcurf = PACKED_CTZ(curf);
 							const VertexID vf = lzcurf + i * Packed_Bits;
@@ -126,10 +284,10 @@ namespace Finder
 							for(size_t j = i; j < graph.get_row_length(); j++)
 							{
 								// For the first block, we can use curf (vf is already removed), otherwise get the block
-								Packed curb = j == i? curf : get_neighbors(u, j);
+								Packed curb = j == i? curf : rows.neighbors(u, j);
 
 								// Exclude neighbors of vf
-								curb &= get_non_neighbors(vf, j);
+								curb &= rows.non_neighbors(vf, j);
 
 								while (curb)
 								{
@@ -139,7 +297,7 @@ namespace Finder
 									curb &= ~(Packed(1) << lzcurb);
 
 									path[length / 2 + 1] = vb;
-									if(Find_Rec<decltype(callback), decltype(get_neighbors), decltype(get_non_neighbors), length / 2 - 1, length / 2 + 1, 0>::find_rec(graph, path, forbidden, callback, get_neighbors, get_non_neighbors)) {return;}
+									if(Find_Rec<decltype(callback), R, length / 2 - 1, length / 2 + 1, 0>::find_rec(graph, path, scratch, callback, rows)) {return;}
 								}
 							}
 						}
@@ -149,13 +307,10 @@ namespace Finder
 			else
 			{
 				if constexpr (length > 2) {
-					for (size_t i = 0; i < graph.get_row_length(); ++i)
-					{
-						f[i] = 0;
-					}
+					std::fill(f, f + graph.get_row_length(), 0);
 				}
 
-				for(VertexID u = 0; u < graph.size(); u++) // outer loop: first node u
+				for(VertexID u = begin; u < end; u++) // outer loop: first node u
 				{
 					// Set bit u in f
 					if constexpr (length > 2) f[u / Packed_Bits] |= Packed(1) << (u % Packed_Bits);
@@ -167,14 +322,14 @@ namespace Finder
 						// Second half: explore actual neighbors v.
 						// For first Packed item (i == u / Packed_Bits) (that contains u), mask all bits up to (and including) position u (% Packed_Bits)
 						// So basically these two loops are graph.next_neighbor(u, v), where v is initially u.
-						for(Packed cur = i == u / Packed_Bits? get_neighbors(u, i) & ~((Packed(2) << (u % Packed_Bits)) - 1) : get_neighbors(u, i); cur; cur &= ~(Packed(1) << PACKED_CTZ(cur)))
+						for(Packed cur = i == u / Packed_Bits? rows.neighbors(u, i) & ~((Packed(2) << (u % Packed_Bits)) - 1) : rows.neighbors(u, i); cur; cur &= ~(Packed(1) << PACKED_CTZ(cur)))
 						{
 							VertexID v = PACKED_CTZ(cur) + i * Packed_Bits;
 							// Set bit v in f
 							if constexpr (length > 2) f[v / Packed_Bits] |= Packed(1) << (v % Packed_Bits);
 							path[length / 2] = v;
 							// Path now contains the two node u and v
-							if(Find_Rec<decltype(callback), decltype(get_neighbors), decltype(get_non_neighbors), length / 2 - 1, length / 2, 0>::find_rec(graph, path, forbidden, callback, get_neighbors, get_non_neighbors)) {return;}
+							if(Find_Rec<decltype(callback), R, length / 2 - 1, length / 2, 0>::find_rec(graph, path, scratch, callback, rows)) {return;}
 							// Unset v in f
 							if constexpr (length > 2) f[v / Packed_Bits] &= ~(Packed(1) << (v % Packed_Bits));
 						}
@@ -184,54 +339,47 @@ namespace Finder
 			}
 		}
 
+	public:
 		/**
 		 * List all forbidden subgraphs that contain the given node @a uu and @a vv.
 		 * The algorithm first completes the inner part between the two nodes (if there is no edge) and then completes the outer part and calls the given @a callback for all found subgraphs.
-		 * The algorithm lists each path that contains the two nodes exactly once and each cycles that contains the two nodes exactly length times.
+		 * The algorithm lists each path and each cycle that contains the two nodes exactly once, except for Skip conversion, where each cycle is listed once per closing pair other than (uu, vv).
 		 */
 		template<typename F>
 		void find_near(Graph const &graph, VertexID uu, VertexID vv, F callback)
 		{
-			auto get_neighbors = [&graph](VertexID u, size_t i) { return graph.get_row(u)[i]; };
-			auto get_non_neighbors = [&graph](VertexID u, size_t i) { return ~graph.get_row(u)[i]; };
-
-			find_near(graph, uu, vv, callback, get_neighbors, get_non_neighbors);
+			Rows rows(graph);
+			find_near_rows(graph, uu, vv, callback, rows);
 		}
 
 		/**
 		 * List all forbidden subgraphs that contain the given node @a uu and @a vv.
 		 * The algorithm first completes the inner part between the two nodes (if there is no edge) and then completes the outer part and calls the given @a callback for all found subgraphs.
-		 * The algorithm lists each path that contains the two nodes exactly once and each cycles that contains the two nodes exactly length times.
+		 * The algorithm lists each path and each cycle that contains the two nodes exactly once, except for Skip conversion, where each cycle is listed once per closing pair other than (uu, vv).
 		 */
 		template<typename F>
-		void find_near(Graph const &graph, VertexID uu, VertexID vv, F callback, Graph_Edits &forbidden_pairs)
+		void find_near(Graph const &graph, VertexID uu, VertexID vv, F callback, Graph_Edits const &forbidden_pairs)
 		{
 
 			assert(!forbidden_pairs.has_edge(uu, vv));
-			auto get_neighbors = [&graph, &forbidden_pairs](VertexID u, size_t i) { return graph.get_row(u)[i] & ~forbidden_pairs.get_row(u)[i]; };
-			auto get_non_neighbors = [&graph, &forbidden_pairs](VertexID u, size_t i) { return ~graph.get_row(u)[i] & ~forbidden_pairs.get_row(u)[i]; };
-
-			find_near(graph, uu, vv, callback, get_neighbors, get_non_neighbors);
+			Masked_Rows rows(graph, forbidden_pairs);
+			find_near_rows(graph, uu, vv, callback, rows);
 		}
 
 		/**
 		 * List all forbidden subgraphs that contain the given node @a uu and @a vv.
 		 * The algorithm first completes the inner part between the two nodes (if there is no edge) and then completes the outer part and calls the given @a callback for all found subgraphs.
-		 * The algorithm lists each path that contains the two nodes exactly once and each cycles that contains the two nodes exactly length times.
+		 * The algorithm lists each path and each cycle that contains the two nodes exactly once, except for Skip conversion, where each cycle is listed once per closing pair other than (uu, vv).
 		 */
-		template<typename F, typename G, typename H>
-		void find_near(Graph const &graph, VertexID uu, VertexID vv, F &callback, G &get_neighbors, H &get_non_neighbors)
+		template<typename F, typename R>
+		void find_near_rows(Graph const &graph, VertexID uu, VertexID vv, F &callback, R const &rows)
 		{
 			std::array<VertexID, length> path;
 
 			if constexpr (length > 2)
 			{
 				Packed *f = forbidden.data();
-
-				for (size_t i = 0; i < graph.get_row_length(); ++i)
-				{
-					f[i] = 0;
-				}
+				std::fill(f, f + graph.get_row_length(), 0);
 
 				f[uu / Packed_Bits] |= (Packed(1) << (uu % Packed_Bits));
 				f[vv / Packed_Bits] |= (Packed(1) << (vv % Packed_Bits));
@@ -248,15 +396,14 @@ namespace Finder
 					path[i.value] = uu;
 					path[i.value + 1] = vv;
 
-					if (Find_Rec<F, G, H, i.value, i.value + 1, 0>::find_rec(graph, path, forbidden, callback, get_neighbors, get_non_neighbors))
+					if (Find_Rec<F, R, i.value, i.value + 1, 0>::find_rec(graph, path, forbidden, callback, rows))
 					{
 						shall_return = true;
 					}
 				});
 
-				// TODO: this is only necessary because we list all Cs length times.
-				// Eliminate the extra listings from the regular listing!
-				if constexpr (with_cycles && !std::is_same<Conversion, Options::Conversions::Skip>::value)
+				// The placements above never close a cycle with (uu, vv), list the cycles for which it is the canonical closing pair
+				if constexpr (unique_cycles)
 				{
 					if (!shall_return)
 					{
@@ -265,10 +412,10 @@ namespace Finder
 
 						auto cb = [&]() -> bool
 							{
-								return callback(path);
+								return closed_canonically(path) && callback(path);
 							};
 
-						Find_Inner_Rec<decltype(cb), G, H, 0, length - 1, 0>::find_inner_rec(graph, path, forbidden, cb, get_neighbors, get_non_neighbors);
+						Find_Inner_Rec<decltype(cb), R, 0, length - 1, 0>::find_inner_rec(graph, path, forbidden, cb, rows);
 					}
 				}
 			}
@@ -292,14 +439,10 @@ namespace Finder
 						// Mark all nodes in the found part + all neighbors of all inner nodes as forbidden
 						// First: inner nodes
 						Packed *f = forbidden.data() + (lb - lf) * graph.get_row_length();
-						for (size_t i = 0; i < graph.get_row_length(); ++i)
+						rows.copy_excluded(f, path[lf + 1]);
+						for (size_t j = lf + 2; j < lb; ++j)
 						{
-							f[i] = 0;
-
-							for (size_t j = lf + 1; j < lb; ++j)
-							{
-								f[i] |= ~get_non_neighbors(path[j], i);
-							}
+							rows.add_excluded(f, f, path[j]);
 						}
 
 						// All nodes in the found part
@@ -329,7 +472,7 @@ namespace Finder
 							}
 
 							// Recursion to find the outer part
-							shall_return = Find_Rec<F, G, H, inner_lf, inner_lb, (lb - lf)>::find_rec(graph, path, forbidden, callback, get_neighbors, get_non_neighbors);
+							shall_return = Find_Rec<F, R, inner_lf, inner_lb, (lb - lf)>::find_rec(graph, path, forbidden, callback, rows);
 
 							// Move back to the start (left to right)
 							if constexpr (j.value > 0)
@@ -344,7 +487,7 @@ namespace Finder
 						return shall_return;
 					};
 
-					if (Find_Inner_Rec<decltype(cb), G, H, lf, lb, 0>::find_inner_rec(graph, path, forbidden, cb, get_neighbors, get_non_neighbors))
+					if (Find_Inner_Rec<decltype(cb), R, lf, lb, 0>::find_inner_rec(graph, path, forbidden, cb, rows))
 					{
 						shall_return = true;
 					}
@@ -359,9 +502,147 @@ namespace Finder
 			}
 		}
 
+		/**
+		 * Counts the subgraphs find() lists, without listing them.
+		 * For length 4, find() lists a path a-u-v-d once for its central edge (u, v) with u < v, so with A = N(u) \ N[v] and D = N(v) \ N[u]
+		 * every a in A forms one with every d in D \ N(a), and with the d in D \cap N(a) for which the cycle is listed.
+		 * With Skip, every cycle is listed. Otherwise only the (a, d) closing a cycle canonically are, these few cycles are counted per d.
+		 * The number of listed subgraphs containing a vertex pair thus follows from the sizes of A and D and their intersections with single rows.
+		 * Only the pairs (a, d) need a loop over the subgraphs, and only if the conversion counts them at all.
+		 * Calls add(x, y, count) for the editable pairs as chosen by for_all_edges_unordered, possibly several times for the same pair.
+		 * Returns the number of listed subgraphs.
+		 */
+		template<typename F>
+		size_t count(Graph const &graph, Graph_Edits const &edited, F add)
+		{
+			static_assert(can_count, "Subgraphs can only be counted without listing them for length 4");
+
+			constexpr bool delete_only = std::is_same<Mode, Options::Modes::Delete>::value;
+			constexpr bool insert_only = std::is_same<Mode, Options::Modes::Insert>::value;
+			// pairs (a, u), (u, v), (v, d)
+			constexpr bool path_pairs = !insert_only;
+			// pairs (a, v), (u, d)
+			constexpr bool chord_pairs = !delete_only;
+			// pairs (a, d)
+			constexpr bool end_pairs = !std::is_same<Conversion, Options::Conversions::Skip>::value;
+			// every cycle a-u-v-d is listed
+			constexpr bool all_cycles = with_cycles && !unique_cycles;
+
+			auto add_editable = [&](VertexID x, VertexID y, size_t num)
+			{
+				if constexpr (!std::is_same<Restriction, Options::Restrictions::None>::value)
+				{
+					if (edited.has_edge(x, y)) {return;}
+				}
+				if (num > 0) {add(x, y, num);}
+			};
+
+			const size_t row_length = graph.get_row_length();
+			Packed *A = forbidden.data();
+			Packed *D = A + row_length;
+			size_t num_subgraphs = 0;
+			// canonically closed cycles per d of the current central edge
+			std::vector<size_t> cycles_with(unique_cycles ? graph.size() : 0, 0);
+
+			for (VertexID u = 0; u < graph.size(); ++u)
+			{
+				graph.for_neighbours(u, [&](VertexID v)
+				{
+					if (v < u) {return false;}
+
+					Packed const *urow = graph.get_row(u);
+					std::copy(urow, urow + row_length, A);
+					::Graph::Row::andnot_rows(A, A, graph.get_row(v), row_length);
+					A[v / Packed_Bits] &= ~(Packed(1) << (v % Packed_Bits));
+
+					Packed const *vrow = graph.get_row(v);
+					std::copy(vrow, vrow + row_length, D);
+					::Graph::Row::andnot_rows(D, D, graph.get_row(u), row_length);
+					D[u / Packed_Bits] &= ~(Packed(1) << (u % Packed_Bits));
+
+					const size_t size_A = ::Graph::Row::popcount(A, row_length);
+					const size_t size_D = ::Graph::Row::popcount(D, row_length);
+					size_t listed = 0;
+
+					for (size_t i = 0; i < row_length; ++i)
+					{
+						for (Packed cur = A[i]; cur; cur &= cur - 1)
+						{
+							const VertexID a = PACKED_CTZ(cur) + i * Packed_Bits;
+							Packed const *arow = graph.get_row(a);
+							size_t with_a = all_cycles ? size_D : 0;
+
+							if constexpr (!all_cycles)
+							{
+								for (size_t j = 0; j < row_length; ++j)
+								{
+									Packed partners = D[j] & ~arow[j];
+									if constexpr (unique_cycles)
+									{
+										for (Packed cycles = D[j] & arow[j]; cycles; cycles &= cycles - 1)
+										{
+											const VertexID d = PACKED_CTZ(cycles) + j * Packed_Bits;
+											if (closed_canonically({a, u, v, d}))
+											{
+												partners |= cycles & ~(cycles - 1);
+												++cycles_with[d];
+											}
+										}
+									}
+									with_a += PACKED_POP(partners);
+									if constexpr (end_pairs)
+									{
+										if constexpr (delete_only) {partners &= arow[j];}
+										else if constexpr (insert_only) {partners &= ~arow[j];}
+										for (; partners; partners &= partners - 1)
+										{
+											add_editable(a, PACKED_CTZ(partners) + j * Packed_Bits, 1);
+										}
+									}
+								}
+							}
+
+							listed += with_a;
+							if constexpr (path_pairs) {add_editable(a, u, with_a);}
+							if constexpr (chord_pairs) {add_editable(a, v, with_a);}
+						}
+					}
+
+					for (size_t i = 0; i < row_length; ++i)
+					{
+						for (Packed cur = D[i]; cur; cur &= cur - 1)
+						{
+							const VertexID d = PACKED_CTZ(cur) + i * Packed_Bits;
+							size_t with_d = size_A;
+							if constexpr (!all_cycles)
+							{
+								Packed const *drow = graph.get_row(d);
+								with_d = 0;
+								for (size_t j = 0; j < row_length; ++j) {with_d += PACKED_POP(A[j] & ~drow[j]);}
+								if constexpr (unique_cycles)
+								{
+									with_d += cycles_with[d];
+									cycles_with[d] = 0;
+								}
+							}
+
+							if constexpr (path_pairs) {add_editable(v, d, with_d);}
+							if constexpr (chord_pairs) {add_editable(u, d, with_d);}
+						}
+					}
+
+					if constexpr (path_pairs) {add_editable(u, v, listed);}
+					num_subgraphs += listed;
+					return false;
+				});
+			}
+
+			return num_subgraphs;
+		}
+
 	private:
 
-		template <typename F, typename G, typename H, size_t lf, size_t lb, size_t depth>
+		template <typename F, typename R, size_t lf, size_t lb, size_t depth>
 		class Find_Inner_Rec
 		{
 		public:
@@ -373,7 +654,7 @@ namespace Finder
 			 * In the last step, if there is only a single node left, common neighbors are enumerated.
 			 * The given callback @a callback is called without parameters.
 			 */
-			static bool find_inner_rec(Graph const &graph, std::array<VertexID, length> &path, std::vector<Packed> &forbidden, F &callback, G &get_neighbors, H &get_non_neighbors)
+			static bool find_inner_rec(Graph const &graph, std::array<VertexID, length> &path, std::vector<Packed> &forbidden, F &callback, R const &rows)
 			{
 				constexpr size_t remaining_length = lb - lf;
 
@@ -386,7 +667,7 @@ namespace Finder
 				{
 					for (size_t i = 0; i < graph.get_row_length(); ++i)
 					{
-						Packed cur = get_neighbors(path[lf], i) & get_neighbors(path[lb], i) & ~f[i];
+						Packed cur = rows.neighbors(path[lf], i) & rows.neighbors(path[lb], i) & ~f[i];
 
 						while (cur)
 						{
@@ -411,14 +692,11 @@ namespace Finder
 					// TODO: this generically goes lf -> lf+1. However, similar to bidirectional dijkstra, it would be better to recurse also with lb -> lb + 1 (note that this is only useful for length > 4 though).
 					Packed *nf = f + graph.get_row_length();
 
-					for (size_t i = 0; i < graph.get_row_length(); ++i)
-					{
-						nf[i] = f[i] | ~get_non_neighbors(path[lf], i);
-					}
+					rows.add_excluded(nf, f, path[lf]);
 
 					for (size_t i = 0; i < graph.get_row_length(); ++i)
 					{
-						Packed cur = get_neighbors(path[lf], i) & get_non_neighbors(path[lb], i) & ~f[i];
+						Packed cur = rows.neighbors(path[lf], i) & rows.non_neighbors(path[lb], i) & ~f[i];
 
 						while (cur)
 						{
@@ -429,7 +707,7 @@ namespace Finder
 
 							path[lf + 1] = v;
 
-							if (Find_Inner_Rec<F, G, H, lf + 1, lb, depth + 1>::find_inner_rec(graph, path, forbidden, callback, get_neighbors, get_non_neighbors))
+							if (Find_Inner_Rec<F, R, lf + 1, lb, depth + 1>::find_inner_rec(graph, path, forbidden, callback, rows))
 							{
 								return true;
 							}
@@ -442,7 +720,7 @@ namespace Finder
 
 		};
 
-		template<typename F, typename G, typename H, size_t lf, size_t lb, size_t depth>
+		template<typename F, typename R, size_t lf, size_t lb, size_t depth>
 		class Find_Rec
 		{
 		public:
@@ -454,7 +732,7 @@ namespace Finder
 			 * already in the path path[lf]..path[lb] and all neighbors of all inner nodes are marked in forbidden in the row at
 			 * depth (template parameter). The function uses the next row in forbidden for the next recursive call.
 			 */
-			static bool find_rec(Graph const &graph, std::array<VertexID, length>& path, std::vector<Packed> &forbidden, F &callback, G& get_neighbors, H& get_non_neighbors)
+			static bool find_rec(Graph const &graph, std::array<VertexID, length>& path, std::vector<Packed> &forbidden, F &callback, R const &rows)
 			{
 				static_assert(lf > 0 || lb < length - 1);
 				constexpr size_t remaining_length = length - (lb - lf) - 1;
@@ -475,25 +753,22 @@ namespace Finder
 					if constexpr (remaining_length > 1)
 					{
 						Packed *nf = f + graph.get_row_length();
-						for(size_t i = 0; i < graph.get_row_length(); i++)
-						{
-							nf[i] = ~get_non_neighbors(base_node, i) | f[i];
-						}
+						rows.add_excluded(nf, f, base_node);
 					}
 
 					// Find the next node that is adjacent to base_node but not opposed_node unless this is the last node and we allow cycles
 					for(size_t i = 0; i < graph.get_row_length(); i++)
 					{
-						Packed curf = get_neighbors(base_node, i) & ~f[i];
+						Packed curf = rows.neighbors(base_node, i) & ~f[i];
 						if constexpr (remaining_length > 1 || !with_cycles)
 						{
 							// ensure there is no edge vf, opposed_node by excluding neighbors of opposed_node
-							curf &= get_non_neighbors(opposed_node, i);
+							curf &= rows.non_neighbors(opposed_node, i);
 						}
 						else if constexpr (!std::is_same<Conversion, Options::Conversions::Skip>::value)
 						{
 							// ensure that either there is an edge or there is no edge, this means the pair is not excluded
-							curf &= get_neighbors(opposed_node, i) | get_non_neighbors(opposed_node, i);
+							curf &= rows.neighbors(opposed_node, i) | rows.non_neighbors(opposed_node, i);
 						}
 
 						(void) opposed_node;
@@ -512,7 +787,7 @@ namespace Finder
 							// Further, we have ensured that there is no edge between uf and opposed_node if lf > 1.
 							assert(remaining_length == 1 || !graph.has_edge(vf, opposed_node));
 
-							if(Find_Rec<F, G, H, next_lf, next_lb, depth + 1>::find_rec(graph, path, forbidden, callback, get_neighbors, get_non_neighbors))
+							if(Find_Rec<F, R, next_lf, next_lb, depth + 1>::find_rec(graph, path, forbidden, callback, rows))
 							{
 								return true;
 							}
@@ -523,11 +798,11 @@ namespace Finder
 			}
 		};
 
-		template<typename F, typename G, typename H, size_t depth>
-		class Find_Rec<F, G, H, 0, length - 1, depth>
+		template<typename F, typename R, size_t depth>
+		class Find_Rec<F, R, 0, length - 1, depth>
 		{
 		public:
-			static bool find_rec(Graph const &g, const std::array<VertexID, length> &path, std::vector<Packed> &, F &callback, G&, H&)
+			static bool find_rec(Graph const &g, const std::array<VertexID, length> &path, std::vector<Packed> &, F &callback, R const &)
 			{
 				(void)g;
 
@@ -540,6 +815,11 @@ namespace Finder
 					}
 				}
 
+				if constexpr (unique_cycles)
+				{
+					if (g.has_edge(path.front(), path.back()) && !closed_canonically(path)) {return false;}
+				}
+
 				return callback(path);
 			}
 		};
@@ -552,7 +832,7 @@ namespace Finder
 	private: using Parent = Center<Graph, Graph_Edits, Mode, Restriction, Conversion, 2, false>;
 	public:
 		static constexpr char const *name = "Center_P2";
-		Center_P2(VertexID graph_size) : Parent(graph_size) {;}
+		Center_P2(typename Parent::VertexID graph_size) : Parent(graph_size) {;}
 	};
 
 	template<typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion>
@@ -561,7 +841,7 @@ namespace Finder
 	private: using Parent = Center<Graph, Graph_Edits, Mode, Restriction, Conversion, 3, false>;
 	public:
 		static constexpr char const *name = "Center_P3";
-		Center_P3(VertexID graph_size) : Parent(graph_size) {;}
+		Center_P3(typename Parent::VertexID graph_size) : Parent(graph_size) {;}
 	};
 
 	template<typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion>
@@ -570,7 +850,7 @@ namespace Finder
 	private: using Parent = Center<Graph, Graph_Edits, Mode, Restriction, Conversion, 4, true>;
 	public:
 		static constexpr char const *name = "Center_4";
-		Center_4(VertexID graph_size) : Parent(graph_size) {;}
+		Center_4(typename Parent::VertexID graph_size) : Parent(graph_size) {;}
 	};
 
 	template<typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion>
@@ -579,7 +859,7 @@ namespace Finder
 	private: using Parent = Center<Graph, Graph_Edits, Mode, Restriction, Conversion, 4, false>;
 	public:
 		static constexpr char const *name = "Center_P4";
-		Center_P4(VertexID graph_size) : Parent(graph_size) {;}
+		Center_P4(typename Parent::VertexID graph_size) : Parent(graph_size) {;}
 	};
 
 	template<typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion>
@@ -588,7 +868,7 @@ namespace Finder
 	private: using Parent = Center<Graph, Graph_Edits, Mode, Restriction, Conversion, 5, true>;
 	public:
 		static constexpr char const *name = "Center_5";
-		Center_5(VertexID graph_size) : Parent(graph_size) {;}
+		Center_5(typename Parent::VertexID graph_size) : Parent(graph_size) {;}
 	};
 
 	template<typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion>
@@ -597,7 +877,7 @@ namespace Finder
 	private: using Parent = Center<Graph, Graph_Edits, Mode, Restriction, Conversion, 5, false>;
 	public:
 		static constexpr char const *name = "Center_P5";
-		Center_P5(VertexID graph_size) : Parent(graph_size) {;}
+		Center_P5(typename Parent::VertexID graph_size) : Parent(graph_size) {;}
 	};
 
 	template<typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion>
@@ -606,7 +886,7 @@ namespace Finder
 	private: using Parent = Center<Graph, Graph_Edits, Mode, Restriction, Conversion, 6, true>;
 	public:
 		static constexpr char const *name = "Center_6";
-		Center_6(VertexID graph_size) : Parent(graph_size) {;}
+		Center_6(typename Parent::VertexID graph_size) : Parent(graph_size) {;}
 	};
 
 	template<typename Graph, typename Graph_Edits, typename Mode, typename Restriction, typename Conversion>
@@ -615,7 +895,7 @@ namespace Finder
 	private: using Parent = Center<Graph, Graph_Edits, Mode, Restriction, Conversion, 6, false>;
 	public:
 		static constexpr char const *name = "Center_P6";
-		Center_P6(VertexID graph_size) : Parent(graph_size) {;}
+		Center_P6(typename Parent::VertexID graph_size) : Parent(graph_size) {;}
 	};
 }
 
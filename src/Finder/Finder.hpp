@@ -165,6 +165,30 @@ namespace Finder
 		}
 		return false;
 	}
+
+	/** Forbidden subgraphs containing an edited vertex pair, enumerated once per edit.
+	 * The editors pass them to the subgraph stats and to all consumers instead of each one calling find_near on its own.
+	 */
+	template<typename VertexID, size_t length>
+	struct Edit_Delta
+	{
+		using subgraph_t = std::array<VertexID, length>;
+
+		/* subgraphs containing the pair before the edit */
+		std::vector<subgraph_t> destroyed;
+		/* subgraphs containing the pair after the edit */
+		std::vector<subgraph_t> created;
+
+		template<typename Finder_impl, typename Graph>
+		static void find(Finder_impl &finder, Graph const &graph, VertexID u, VertexID v, std::vector<subgraph_t> &subgraphs)
+		{
+			subgraphs.clear();
+			finder.find_near(graph, u, v, [&](subgraph_t const &path) {
+				subgraphs.push_back(path);
+				return false;
+			});
+		}
+	};
 }
 
 #endif
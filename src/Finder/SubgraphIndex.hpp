@@ -0,0 +1,331 @@
+#ifndef FINDER_SUBGRAPH_INDEX_HPP
+#define FINDER_SUBGRAPH_INDEX_HPP
+
+#include <assert.h>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "../config.hpp"
+#include "../Options.hpp"
+#include "../Graph/ValueMatrix.hpp"
+#include "Finder.hpp"
+
+namespace Finder
+{
+	/** All forbidden subgraphs of the current graph, each with an id that stays the same as long as the subgraph exists.
+	 * Every vertex pair of a subgraph lists the subgraph's id, so the subgraphs sharing a pair are found without a search.
+	 * The editors remove and add the subgraphs containing an edited pair, and undo an edit by restoring the removed subgraphs under their old ids.
+	 * Ids are recycled in LIFO order, this is what lets undo_edit() get back the old ids.
+	 */
+	template<typename Graph, typename Mode, typename Conversion, size_t length>
+	class Subgraph_Index
+	{
+	public:
+		using VertexID = typename Graph::VertexID;
+		using subgraph_t = std::array<VertexID, length>;
+		static constexpr size_t num_pairs = length * (length - 1) / 2;
+
+	private:
+		/* storage of subgraph id, only valid if live[id] */
+		std::vector<subgraph_t> subgraphs;
+		std::vector<bool> live;
+		/* for each pair of a subgraph: position of the id in the list of the pair */
+		std::vector<std::array<size_t, num_pairs>> positions;
+		std::vector<size_t> free_ids;
+		size_t num_subgraphs;
+
+		/* entries are id * 2 + 1 if the pair is one of the pairs for_all_edges_unordered lists for the subgraph, ignoring the restriction, id * 2 otherwise */
+		Value_Matrix<std::vector<size_t>> subgraphs_at;
+
+		/* removed and added subgraphs of each edit that has not been undone */
+		struct Change
+		{
+			std::vector<std::pair<size_t, subgraph_t>> removed;
+			std::vector<size_t> added;
+		};
+		std::vector<Change> changes;
+
+	public:
+		Subgraph_Index(VertexID n) : num_subgraphs(0), subgraphs_at(n) {;}
+
+		bool enabled() const
+		{
+			return subgraphs_at.size() > 0;
+		}
+
+		/** Number of subgraphs */
+		size_t size() const
+		{
+			return num_subgraphs;
+		}
+
+		/** All ids are less than this */
+		size_t id_bound() const
+		{
+			return subgraphs.size();
+		}
+
+		bool contains(size_t id) const
+		{
+			return id < live.size() && live[id];
+		}
+
+		subgraph_t const &get(size_t id) const
+		{
+			assert(contains(id));
+			return subgraphs[id];
+		}
+
+		/** Calls callback(id) for all subgraphs */
+		template<typename F>
+		void for_all(F callback) const
+		{
+			for (size_t id = 0; id < subgraphs.size(); ++id)
+			{
+				if (live[id]) {callback(id);}
+			}
+		}
+
+		/** Calls callback(id) for the subgraphs that contain (x, y) as one of the pairs listed by for_all_edges_unordered, regardless of the restriction */
+		template<typename F>
+		void for_subgraphs_at(VertexID x, VertexID y, F callback) const
+		{
+			for (size_t entry : subgraphs_at.at(x, y))
+			{
+				if (entry & 1) {callback(entry >> 1);}
+			}
+		}
+
+		/** Calls callback(id) for all subgraphs that contain both x and y */
+		template<typename F>
+		void for_subgraphs_containing(VertexID x, VertexID y, F callback) const
+		{
+			for (size_t entry : subgraphs_at.at(x, y))
+			{
+				callback(entry >> 1);
+			}
+		}
+
+		/** Subgraphs removed and added by the last edit */
+		std::vector<std::pair<size_t, subgraph_t>> const &last_removed() const
+		{
+			assert(!changes.empty());
+			return changes.back().removed;
+		}
+
+		std::vector<size_t> const &last_added() const
+		{
+			assert(!changes.empty());
+			return changes.back().added;
+		}
+
+		template<typename Finder_impl>
+		void initialize(Finder_impl &finder, Graph const &graph, size_t threads)
+		{
+			if (!enabled()) return;
+			clear();
+
+			finder.find_parallel(graph, threads, [&](subgraph_t const &path)
+			{
+				add(graph, path);
+				return false;
+			});
+		}
+
+		/** Removes all subgraphs the edit of (u, v) destroys, to be called before the edit */
+		void before_edit(VertexID u, VertexID v)
+		{
+			if (!enabled()) return;
+			Change &change = changes.emplace_back();
+
+			std::vector<size_t> const &at_uv = subgraphs_at.at(u, v);
+			for (size_t i = at_uv.size(); i-- > 0;)
+			{
+				const size_t id = at_uv[i] >> 1;
+				subgraph_t const &path = subgraphs[id];
+				// With Skip, the subgraph ending in u and v is converted by the edit and thus stays
+				if constexpr (std::is_same<Conversion, Options::Conversions::Skip>::value)
+				{
+					if ((path.front() == u && path.back() == v) || (path.front() == v && path.back() == u)) {continue;}
+				}
+				change.removed.emplace_back(id, path);
+				// moves the last id to position i, it has been looked at already
+				remove(id);
+			}
+		}
+
+		/** Adds the subgraphs the edit created, to be called after the edit */
+		void after_edit(Graph const &graph, subgraph_t const &path)
+		{
+			if (!enabled()) return;
+			assert(!changes.empty());
+			changes.back().added.push_back(add(graph, path));
+		}
+
+		/** Reverts the last before_edit() and after_edit() calls, to be called after the edit was reverted. The removed subgraphs get their old ids back */
+		void undo_edit(Graph const &graph)
+		{
+			if (!enabled()) return;
+			assert(!changes.empty());
+			Change &change = changes.back();
+			for (auto it = change.added.rbegin(); it != change.added.rend(); ++it)
+			{
+				remove(*it);
+			}
+			for (auto it = change.removed.rbegin(); it != change.removed.rend(); ++it)
+			{
+				assert(!free_ids.empty() && free_ids.back() == it->first);
+				free_ids.pop_back();
+				insert(it->first, it->second, editable_pairs(graph, it->second));
+			}
+			changes.pop_back();
+		}
+
+		/** Check against the subgraphs the finder lists in the current graph */
+		template<typename Finder_impl>
+		void verify(Finder_impl &finder, Graph const &graph) const
+		{
+			(void) finder; (void) graph;
+#ifndef NDEBUG
+			if (!enabled()) return;
+			std::map<subgraph_t, size_t> listed;
+			size_t count = 0;
+			for_all([&](size_t id)
+			{
+				++listed[normalized(subgraphs[id])];
+				++count;
+				for (size_t j = 1; j < length; ++j)
+				{
+					for (size_t i = 0; i < j; ++i)
+					{
+						assert(subgraphs_at.at(subgraphs[id][i], subgraphs[id][j])[positions[id][j * (j - 1) / 2 + i]] >> 1 == id);
+					}
+				}
+			});
+			assert(count == num_subgraphs);
+			(void) count;
+
+			finder.find(graph, [&](subgraph_t const &path)
+			{
+				auto it = listed.find(normalized(path));
+				assert(it != listed.end() && it->second > 0);
+				--it->second;
+				return false;
+			});
+			for (auto const &entry : listed) {assert(entry.second == 0); (void) entry;}
+#endif
+		}
+
+	private:
+		void clear()
+		{
+			subgraphs.clear();
+			live.clear();
+			positions.clear();
+			free_ids.clear();
+			changes.clear();
+			num_subgraphs = 0;
+			subgraphs_at.forAllNodePairs([](VertexID, VertexID, std::vector<size_t> &ids) {ids.clear();});
+		}
+
+		static std::array<bool, num_pairs> editable_pairs(Graph const &graph, subgraph_t const &path)
+		{
+			std::array<bool, num_pairs> result;
+			result.fill(false);
+			// The edits recorded by the editors don't matter here, the consumers filter them
+			for_all_edges_unordered<Mode, Options::Restrictions::None, Conversion>(graph, graph, path.begin(), path.end(), [&](auto uit, auto vit)
+			{
+				size_t i = uit - path.begin(), j = vit - path.begin();
+				if (i > j) {std::swap(i, j);}
+				result[j * (j - 1) / 2 + i] = true;
+				return false;
+			});
+			return result;
+		}
+
+		size_t add(Graph const &graph, subgraph_t const &path)
+		{
+			size_t id;
+			if (free_ids.empty())
+			{
+				id = subgraphs.size();
+				subgraphs.emplace_back();
+				live.push_back(false);
+				positions.emplace_back();
+			}
+			else
+			{
+				id = free_ids.back();
+				free_ids.pop_back();
+			}
+			insert(id, path, editable_pairs(graph, path));
+			return id;
+		}
+
+		void insert(size_t id, subgraph_t const &path, std::array<bool, num_pairs> const &path_editable)
+		{
+			assert(!live[id]);
+			subgraphs[id] = path;
+			live[id] = true;
+			++num_subgraphs;
+			for (size_t j = 1; j < length; ++j)
+			{
+				for (size_t i = 0; i < j; ++i)
+				{
+					std::vector<size_t> &ids = subgraphs_at.at(path[i], path[j]);
+					positions[id][j * (j - 1) / 2 + i] = ids.size();
+					ids.push_back(id * 2 + path_editable[j * (j - 1) / 2 + i]);
+				}
+			}
+		}
+
+		void remove(size_t id)
+		{
+			assert(live[id]);
+			subgraph_t const &path = subgraphs[id];
+			for (size_t j = 1; j < length; ++j)
+			{
+				for (size_t i = 0; i < j; ++i)
+				{
+					std::vector<size_t> &ids = subgraphs_at.at(path[i], path[j]);
+					const size_t pos = positions[id][j * (j - 1) / 2 + i];
+					assert(ids[pos] >> 1 == id);
+					const size_t moved = ids.back() >> 1;
+					ids[pos] = ids.back();
+					ids.pop_back();
+					if (moved != id)
+					{
+						positions[moved][pair_index(subgraphs[moved], path[i], path[j])] = pos;
+					}
+				}
+			}
+			live[id] = false;
+			--num_subgraphs;
+			free_ids.push_back(id);
+		}
+
+		/** Index of the pair (x, y) among the pairs of path */
+		static size_t pair_index(subgraph_t const &path, VertexID x, VertexID y)
+		{
+			size_t i = std::find(path.begin(), path.end(), x) - path.begin();
+			size_t j = std::find(path.begin(), path.end(), y) - path.begin();
+			assert(i < length && j < length);
+			if (i > j) {std::swap(i, j);}
+			return j * (j - 1) / 2 + i;
+		}
+
+		/** A listing and its reverse are the same subgraph */
+		static subgraph_t normalized(subgraph_t const &path)
+		{
+			subgraph_t reversed = path;
+			std::reverse(reversed.begin(), reversed.end());
+			return std::min(path, reversed);
+		}
+	};
+}
+
+#endif
@@ -1,8 +1,11 @@
 #ifndef FINDER_SUBGRAPH_COUNTS_HPP
 #define FINDER_SUBGRAPH_COUNTS_HPP
 
+#include "../Graph/CounterMatrix.hpp"
 #include "../Graph/ValueMatrix.hpp"
 #include "../Finder/Finder.hpp"
+#include "../Finder/SubgraphIndex.hpp"
+#include <algorithm>
 #include <array>
 #include <cassert>
 
@@ -12,31 +15,49 @@ namespace Finder
 	class Subgraph_Stats
 	{
 	public:
+		using VertexID = typename Graph::VertexID;
 		using subgraph_t = std::array<VertexID, length>;
-		Value_Matrix<size_t> num_subgraphs_per_edge;
+		Counter_Matrix num_subgraphs_per_edge;
 		size_t num_subgraphs;
 		size_t sum_subgraphs_per_edge;
 		std::vector<size_t> before_mark_count;
+		/* only maintained if constructed with_index */
+		Subgraph_Index<Graph, Mode, Conversion, length> index;
 
 		Finder_impl finder;
 
-		Subgraph_Stats(VertexID n) : num_subgraphs_per_edge(n), num_subgraphs(0), sum_subgraphs_per_edge(0), finder(n) {}
+		Subgraph_Stats(VertexID n, bool with_index = false) : num_subgraphs_per_edge(n), num_subgraphs(0), sum_subgraphs_per_edge(0), index(with_index ? n : 0), finder(n) {}
 
-		void initialize(const Graph& graph, const Graph_Edits& edited)
+		/** Counts all subgraphs, enumerating them with up to threads threads if they can't be counted directly */
+		void initialize(const Graph& graph, const Graph_Edits& edited, size_t threads = 1)
 		{
 			if (num_subgraphs_per_edge.size() == 0) return;
 			if (num_subgraphs > 0)
 			{
-				num_subgraphs_per_edge.forAllNodePairs([&](VertexID, VertexID, size_t &c) {c = 0;});
+				num_subgraphs_per_edge.clear();
 				sum_subgraphs_per_edge = 0;
 				num_subgraphs = 0;
 			}
 
-			finder.find(graph, [&](const subgraph_t& path)
+			index.initialize(finder, graph, threads);
+
+			if constexpr (Finder_impl::can_count)
 			{
-				register_subgraph(graph, edited, path);
-				return false;
-			});
+				num_subgraphs = finder.count(graph, edited, [&](VertexID x, VertexID y, size_t num)
+				{
+					num_subgraphs_per_edge.add(x, y, num);
+					sum_subgraphs_per_edge += num;
+				});
+				verify_num_subgraphs_per_edge(graph, edited);
+			}
+			else
+			{
+				finder.find_parallel(graph, threads, [&](const subgraph_t& path)
+				{
+					register_subgraph(graph, edited, path);
+					return false;
+				});
+			}
 		}
 
 		void before_edit(Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
@@ -47,6 +68,7 @@ namespace Finder
 
 			verify_num_subgraphs_per_edge(graph, edited);
 
+			index.before_edit(u, v);
 			finder.find_near(graph, u, v, [&](const subgraph_t& path)
 			{
 				remove_subgraph(graph, edited, path);
@@ -57,6 +79,31 @@ namespace Finder
 		}
 
 		void after_edit(Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		{
+			if (num_subgraphs_per_edge.size() == 0) return;
+			finder.find_near(graph, u, v, [&](const subgraph_t& path)
+			{
+				register_subgraph(graph, edited, path);
+				index.after_edit(graph, path);
+				return false;
+			});
+
+			verify_num_subgraphs_per_edge(graph, edited);
+			assert(num_subgraphs_per_edge.at(u, v) == 0);
+		}
+
+		/** Reverts before_edit() and after_edit() of the last edit, which must be (u, v). Same as before_edit, but the subgraph index is reverted at once in after_undo_edit() */
+		void before_undo_edit(Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
+		{
+			if (num_subgraphs_per_edge.size() == 0) return;
+			finder.find_near(graph, u, v, [&](const subgraph_t& path)
+			{
+				remove_subgraph(graph, edited, path);
+				return false;
+			});
+		}
+
+		void after_undo_edit(Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v)
 		{
 			if (num_subgraphs_per_edge.size() == 0) return;
 			finder.find_near(graph, u, v, [&](const subgraph_t& path)
@@ -64,17 +111,75 @@ namespace Finder
 				register_subgraph(graph, edited, path);
 				return false;
 			});
+			index.undo_edit(graph);
+
+			verify_num_subgraphs_per_edge(graph, edited);
+		}
+
+		/** Same as before_edit, with the subgraphs containing (u, v) already enumerated */
+		void before_edit(Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v, std::vector<subgraph_t> const &destroyed)
+		{
+			if (num_subgraphs_per_edge.size() == 0) return;
+			(void) u; (void) v;
+
+			assert((edited.has_edge(u, v) || std::is_same<Restriction, Options::Restrictions::None>::value));
+
+			verify_num_subgraphs_per_edge(graph, edited);
+
+			index.before_edit(u, v);
+			for (const subgraph_t& path : destroyed)
+			{
+				remove_subgraph(graph, edited, path);
+			}
+
+			assert(num_subgraphs_per_edge.at(u, v) == 0);
+		}
+
+		/** Same as after_edit, with the subgraphs containing (u, v) already enumerated */
+		void after_edit(Graph const &graph, Graph_Edits const &edited, VertexID u, VertexID v, std::vector<subgraph_t> const &created)
+		{
+			if (num_subgraphs_per_edge.size() == 0) return;
+			(void) u; (void) v;
+
+			for (const subgraph_t& path : created)
+			{
+				register_subgraph(graph, edited, path);
+				index.after_edit(graph, path);
+			}
 
 			verify_num_subgraphs_per_edge(graph, edited);
 			assert(num_subgraphs_per_edge.at(u, v) == 0);
 		}
 
+		/** Same as before_undo_edit, with the subgraphs the edit created */
+		void before_undo_edit(Graph const &graph, Graph_Edits const &edited, VertexID, VertexID, std::vector<subgraph_t> const &created)
+		{
+			if (num_subgraphs_per_edge.size() == 0) return;
+			for (const subgraph_t& path : created)
+			{
+				remove_subgraph(graph, edited, path);
+			}
+		}
+
+		/** Same as after_undo_edit, with the subgraphs the edit destroyed */
+		void after_undo_edit(Graph const &graph, Graph_Edits const &edited, VertexID, VertexID, std::vector<subgraph_t> const &destroyed)
+		{
+			if (num_subgraphs_per_edge.size() == 0) return;
+			for (const subgraph_t& path : destroyed)
+			{
+				register_subgraph(graph, edited, path);
+			}
+			index.undo_edit(graph);
+
+			verify_num_subgraphs_per_edge(graph, edited);
+		}
+
 		void after_mark(Graph const &graph, const Graph_Edits &edited, VertexID u, VertexID v)
 		{
 			if (num_subgraphs_per_edge.size() == 0) return;
 			sum_subgraphs_per_edge -= num_subgraphs_per_edge.at(u, v);
 			before_mark_count.push_back(num_subgraphs_per_edge.at(u, v));
-			num_subgraphs_per_edge.at(u, v) = 0;
+			num_subgraphs_per_edge.set(u, v, 0);
 
 			verify_num_subgraphs_per_edge(graph, edited);
 		}
@@ -82,7 +187,7 @@ namespace Finder
 		void after_unmark(const Graph& graph, const Graph_Edits &edited, VertexID u, VertexID v)
 		{
 			if (num_subgraphs_per_edge.size() == 0) return;
-			num_subgraphs_per_edge.at(u, v) = before_mark_count.back();
+			num_subgraphs_per_edge.set(u, v, before_mark_count.back());
 			sum_subgraphs_per_edge += before_mark_count.back();
 			before_mark_count.pop_back();
 			verify_num_subgraphs_per_edge(graph, edited);
@@ -93,7 +198,7 @@ namespace Finder
 			++num_subgraphs;
 
 			Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit) {
-				++num_subgraphs_per_edge.at(*uit, *vit);
+				num_subgraphs_per_edge.increment(*uit, *vit);
 				++sum_subgraphs_per_edge;
 				return false;
 			});
@@ -104,7 +209,7 @@ namespace Finder
 			--num_subgraphs;
 			Finder::for_all_edges_unordered<Mode, Restriction, Conversion>(graph, edited, path.begin(), path.end(), [&](auto uit, auto vit)
 			{
-				--num_subgraphs_per_edge.at(*uit, *vit);
+				num_subgraphs_per_edge.decrement(*uit, *vit);
 				--sum_subgraphs_per_edge;
 				return false;
 			});
@@ -129,11 +234,15 @@ namespace Finder
 				return false;
 			});
 
+			size_t debug_max = 0;
 			debug_subgraphs.forAllNodePairs([&](VertexID u, VertexID v, size_t debug_num)
 			{
 				assert(num_subgraphs_per_edge.at(u, v) == debug_num);
 				assert(!edited.has_edge(u, v) || debug_num == 0);
+				debug_max = std::max(debug_max, debug_num);
 			});
+			assert(num_subgraphs_per_edge.max() == debug_max);
+			index.verify(finder, graph);
 #endif
 		}
 	};
@@ -0,0 +1,180 @@
+#ifndef GRAPH_COUNTER_MATRIX_HPP
+#define GRAPH_COUNTER_MATRIX_HPP
+
+#include <assert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../config.hpp"
+#include "../Bucket_PQ.hpp"
+
+/** Counters for all vertex pairs, laid out like Value_Matrix.
+ * Counters are stored in 16 bits; the few counters reaching the maximum are kept in an overflow table instead.
+ * Non-zero counters are additionally kept in buckets by value, so the pairs with the largest counter are available without a scan.
+ * The buckets take 4 bytes per pair for its position and 4 more per pair with a non-zero counter,
+ * so a pair takes 6 to 10 bytes instead of the 8 of a Value_Matrix<size_t>.
+ */
+class Counter_Matrix
+{
+public:
+	using value_type = size_t;
+	using counter_type = uint16_t;
+	static constexpr char const *name = "Counter_Matrix";
+
+private:
+	/* marks counters stored in overflow */
+	static constexpr counter_type overflowed = std::numeric_limits<counter_type>::max();
+
+	size_t n;
+	std::vector<counter_type> matrix;
+	std::unordered_map<size_t, value_type> overflow;
+	MaxBucketPQ by_value;
+
+public:
+	Counter_Matrix(size_t n) : n(n), matrix(n * (n - 1) / 2, 0), by_value(matrix.size())
+	{}
+
+	size_t size() const
+	{
+		return n;
+	}
+
+	value_type at(size_t u, size_t v) const
+	{
+		return get(index(u, v));
+	}
+
+	void set(size_t u, size_t v, value_type value)
+	{
+		size_t i = index(u, v);
+		by_value.change_key(i, get(i), value);
+		if(value < overflowed)
+		{
+			if(matrix[i] == overflowed) {overflow.erase(i);}
+			matrix[i] = value;
+		}
+		else
+		{
+			matrix[i] = overflowed;
+			overflow[i] = value;
+		}
+	}
+
+	void increment(size_t u, size_t v)
+	{
+		size_t i = index(u, v);
+		value_type old = get(i);
+		by_value.change_key(i, old, old + 1);
+		if(matrix[i] < overflowed - 1) {matrix[i]++;}
+		else if(matrix[i] == overflowed - 1)
+		{
+			matrix[i] = overflowed;
+			overflow[i] = overflowed;
+		}
+		else {overflow[i]++;}
+	}
+
+	void add(size_t u, size_t v, value_type value)
+	{
+		set(u, v, at(u, v) + value);
+	}
+
+	void decrement(size_t u, size_t v)
+	{
+		size_t i = index(u, v);
+		value_type old = get(i);
+		assert(old > 0);
+		by_value.change_key(i, old, old - 1);
+		if(matrix[i] < overflowed) {matrix[i]--;}
+		else
+		{
+			auto it = overflow.find(i);
+			if(--it->second < overflowed)
+			{
+				matrix[i] = it->second;
+				overflow.erase(it);
+			}
+		}
+	}
+
+	/** Resets all counters to 0 */
+	void clear()
+	{
+		std::fill(matrix.begin(), matrix.end(), 0);
+		overflow.clear();
+		by_value.clear();
+	}
+
+	/** Largest counter value */
+	value_type max() const
+	{
+		return by_value.max_value();
+	}
+
+	/** Calls f(u, v) for all pairs whose counter is value > 0, in no particular order; f must not change the counters */
+	template<typename F>
+	void forAllNodePairsWithValue(value_type value, F f) const
+	{
+		for (size_t i : by_value.elements_with(value))
+		{
+			auto [u, v] = pair(i);
+			f(u, v);
+		}
+	}
+
+	/** The first pair in the order of forAllNodePairs whose counter is value */
+	std::pair<size_t, size_t> firstNodePairWithValue(value_type value) const
+	{
+		if (value > 0)
+		{
+			auto const &indices = by_value.elements_with(value);
+			return pair(*std::min_element(indices.begin(), indices.end()));
+		}
+		return pair(std::find(matrix.begin(), matrix.end(), 0) - matrix.begin());
+	}
+
+	template<typename F>
+	void forAllNodePairs(F f) const {
+		size_t u = 0, v = 1;
+		for (size_t i = 0; i < matrix.size(); ++i) {
+			assert(v * (v - 1) / 2 + u == i);
+			f(u, v, matrix[i] == overflowed ? overflow.at(i) : value_type(matrix[i]));
+			++u;
+			if (u == v)
+			{
+				u = 0;
+				++v;
+			}
+		}
+	}
+
+private:
+	static size_t index(size_t u, size_t v)
+	{
+		assert(u != v);
+		if (u > v) std::swap(u, v);
+		return v * (v - 1) / 2 + u;
+	}
+
+	/** Inverse of index */
+	static std::pair<size_t, size_t> pair(size_t i)
+	{
+		size_t v = (1 + std::sqrt(1 + 8.0 * i)) / 2;
+		while (v * (v - 1) / 2 > i) --v;
+		while ((v + 1) * v / 2 <= i) ++v;
+		return {i - v * (v - 1) / 2, v};
+	}
+
+	value_type get(size_t i) const
+	{
+		return matrix[i] == overflowed ? overflow.at(i) : matrix[i];
+	}
+};
+
+#endif
@@ -1,58 +1,179 @@
 #include <assert.h>
-#include <fstream>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <iostream>
-#include <sstream>
+#include <stdexcept>
 
 #include "../config.hpp"
 
 #include "Graph.hpp"
 
-uint64_t Graph::get_size(std::string const &filename, bool edgelist)
+Graph::Mapped_File::Mapped_File(std::string const &filename) : data(nullptr), length(0)
 {
-	std::ifstream f(filename);
-	std::string line;
-	std::istringstream linestream;
+	int fd = open(filename.c_str(), O_RDONLY);
+	if(fd < 0)
+	{
+		throw std::runtime_error(std::string("Error opening file: ") + filename + ": " + strerror(errno));
+	}
 
-	if(!f)
+	struct stat st;
+	if(fstat(fd, &st))
 	{
-		throw std::runtime_error(std::string("Error opening file: ") + filename);
+		close(fd);
+		throw std::runtime_error(std::string("Error reading file: ") + filename + ": " + strerror(errno));
 	}
 
-	if (edgelist)
+	length = st.st_size;
+	if(length > 0)
 	{
-		uint64_t n = 0;
-		uint64_t u, v;
-		while(f >> u >> v)
+		void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(mapping == MAP_FAILED)
 		{
-			n = std::max(n, std::max(u, v));
+			close(fd);
+			throw std::runtime_error(std::string("Error mapping file: ") + filename + ": " + strerror(errno));
 		}
+		madvise(mapping, length, MADV_SEQUENTIAL);
+		data = static_cast<char const *>(mapping);
+	}
+	close(fd);
+}
 
-		return n + 1;
+Graph::Mapped_File::~Mapped_File()
+{
+	if(data) {munmap(const_cast<char *>(data), length);}
+}
+
+namespace
+{
+	/** Size and modification time (ns) of a file, false if it can't be stat'ed */
+	bool file_version(std::string const &filename, uint64_t &size, uint64_t &mtime)
+	{
+		struct stat st;
+		if(stat(filename.c_str(), &st)) {return false;}
+		size = st.st_size;
+		mtime = static_cast<uint64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+		return true;
 	}
+}
 
-	while(std::getline(f, line))
+Graph::Binary_Reader::~Binary_Reader()
+{
+	if(fd >= 0) {close(fd);}
+}
+
+bool Graph::Binary_Reader::open(std::string const &filename, bool edgelist)
+{
+	uint64_t source_size, source_mtime;
+	if(!file_version(filename, source_size, source_mtime)) {return false;}
+
+	fd = ::open(binary_filename(filename).c_str(), O_RDONLY);
+	if(fd < 0) {return false;}
+
+	struct stat st;
+	bool valid = !fstat(fd, &st) && read(reinterpret_cast<Packed *>(&h), sizeof(h) / sizeof(Packed))
+		&& h.magic == Binary_Header::magic_value && h.version == Binary_Header::version_value && h.packed_size == sizeof(Packed)
+		&& h.edgelist == edgelist && h.source_size == source_size && h.source_mtime == source_mtime
+		&& h.row_length == (h.n + Packed_Bits - 1) / Packed_Bits
+		&& static_cast<uint64_t>(st.st_size) == sizeof(h) + h.n * h.row_length * sizeof(Packed);
+	if(!valid)
 	{
-		if(line[0] != '%') {break;}
+		close(fd);
+		fd = -1;
 	}
-	if(!f)
+	return valid;
+}
+
+bool Graph::Binary_Reader::read(Packed *data, size_t words)
+{
+	char *buf = reinterpret_cast<char *>(data);
+	size_t remaining = words * sizeof(Packed);
+	while(remaining > 0)
 	{
-		throw std::runtime_error(std::string("Premature end of file: ") + filename);
+		ssize_t r = ::read(fd, buf, remaining);
+		if(r < 0 && errno == EINTR) {continue;}
+		if(r <= 0) {return false;}
+		buf += r;
+		remaining -= r;
 	}
+	return true;
+}
 
-	uint64_t n;
-	linestream.str(line);
-	linestream >> n;
-	return n;
+Graph::Binary_Writer::Binary_Writer(std::string const &source, bool edgelist, uint64_t n, uint64_t row_length) : fd(-1), filename(binary_filename(source)), tmp_filename(filename + ".tmp" + std::to_string(getpid()))
+{
+	h = Binary_Header{Binary_Header::magic_value, Binary_Header::version_value, sizeof(Packed), edgelist, n, row_length, 0, 0, 0};
+	if(!file_version(source, h.source_size, h.source_mtime)) {return;}
+
+	fd = open(tmp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd >= 0 && !write(reinterpret_cast<Packed const *>(&h), sizeof(h) / sizeof(Packed)))
+	{
+		close(fd);
+		unlink(tmp_filename.c_str());
+		fd = -1;
+	}
+}
+
+Graph::Binary_Writer::~Binary_Writer()
+{
+	if(fd >= 0)
+	{
+		close(fd);
+		unlink(tmp_filename.c_str());
+	}
+}
+
+bool Graph::Binary_Writer::write(Packed const *data, size_t words)
+{
+	if(fd < 0) {return false;}
+	char const *buf = reinterpret_cast<char const *>(data);
+	size_t remaining = words * sizeof(Packed);
+	while(remaining > 0)
+	{
+		ssize_t r = ::write(fd, buf, remaining);
+		if(r < 0 && errno == EINTR) {continue;}
+		if(r <= 0) {return false;}
+		buf += r;
+		remaining -= r;
+	}
+	return true;
 }
 
-std::vector<VertexID> Graph::invert_permutation(const std::vector<VertexID> &permutation)
+bool Graph::Binary_Writer::commit(uint64_t checksum)
 {
-	std::vector<VertexID> result(permutation.size());
+	if(fd < 0) {return false;}
+	h.checksum = checksum;
+	bool ok = pwrite(fd, &h, sizeof(h), 0) == sizeof(h);
+	ok &= !close(fd);
+	fd = -1;
+	// rename is atomic, concurrent runs never see a partial cache
+	ok = ok && !rename(tmp_filename.c_str(), filename.c_str());
+	if(!ok) {unlink(tmp_filename.c_str());}
+	return ok;
+}
 
-	for (VertexID u = 0; u < permutation.size(); ++u)
+uint64_t Graph::get_size(std::string const &filename, bool edgelist)
+{
+	Binary_Reader reader;
+	if(reader.open(filename, edgelist)) {return reader.header().n;}
+
+	Mapped_File file(filename);
+
+	if (edgelist)
 	{
-		result[permutation[u]] = u;
+		return get_size_edgelist(file);
 	}
 
-	return result;
+	Scanner scanner(file);
+	while(scanner.is_comment()) {scanner.next_line();}
+
+	uint64_t n;
+	if(!scanner.read_in_line(n))
+	{
+		throw std::runtime_error(std::string("Premature end of file: ") + filename);
+	}
+	return n;
 }
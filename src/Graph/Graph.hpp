@@ -11,31 +11,135 @@
 #include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 
 #include "../config.hpp"
 
 namespace Graph
 {
+	/** Read-only memory mapping of a whole file */
+	class Mapped_File
+	{
+	private:
+		char const *data;
+		size_t length;
+
+	public:
+		Mapped_File(std::string const &filename);
+		~Mapped_File();
+		Mapped_File(Mapped_File const &) = delete;
+		Mapped_File &operator=(Mapped_File const &) = delete;
+
+		char const *begin() const {return data;}
+		char const *end() const {return data + length;}
+	};
+
+	/** Parses unsigned integers from a memory mapped file, line by line or as a stream of tokens */
+	class Scanner
+	{
+	private:
+		char const *pos;
+		char const *const end;
+
+	public:
+		Scanner(Mapped_File const &file) : pos(file.begin()), end(file.end()) {;}
+
+		bool at_end() const
+		{
+			return pos == end;
+		}
+
+		bool is_comment() const
+		{
+			return pos != end && *pos == '%';
+		}
+
+		/** Moves to the start of the next line */
+		void next_line()
+		{
+			while(pos != end && *pos != '\n') {pos++;}
+			if(pos != end) {pos++;}
+		}
+
+		/** Reads the next number of the current line, returns false at the end of the line or on anything that is not a number */
+		bool read_in_line(uint64_t &value)
+		{
+			while(pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) {pos++;}
+			return parse(value);
+		}
+
+		/** Reads the next number across line breaks, skipping lines starting with '%' or '#' */
+		bool read(uint64_t &value)
+		{
+			while(pos != end)
+			{
+				if(*pos == '%' || *pos == '#') {next_line();}
+				else if(*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n') {pos++;}
+				else {break;}
+			}
+			return parse(value);
+		}
+
+	private:
+		bool parse(uint64_t &value)
+		{
+			if(pos == end || static_cast<unsigned char>(*pos - '0') > 9) {return false;}
+			value = 0;
+			for(unsigned char digit; pos != end && (digit = *pos - '0') <= 9; pos++)
+			{
+				value = value * 10 + digit;
+			}
+			return true;
+		}
+	};
+
 	/** Number of vertices in the graph stored in filename */
 	uint64_t get_size(std::string const &filename, bool edgelist);
 
-	/** reads a graph in METIS format */
+	/** Row lengths the graphs are additionally instantiated with as compile-time constants, must match generator_template_*.tpp */
+	constexpr size_t fixed_row_lengths[] = {1, 2, 4};
+
+	/** The shortest fixed row length a graph with graph_size vertices fits into, 0 if it needs a row length known only at runtime */
+	inline size_t select_fixed_row_length(uint64_t graph_size)
+	{
+		for(size_t row_length: fixed_row_lengths)
+		{
+			if(graph_size <= row_length * Packed_Bits) {return row_length;}
+		}
+		return 0;
+	}
+
+	/** Number of vertices of an edge list, i.e. the largest vertex id + 1 */
+	inline uint64_t get_size_edgelist(Mapped_File const &file)
+	{
+		Scanner scanner(file);
+		uint64_t n = 0;
+		uint64_t u, v;
+		while(scanner.read(u) && scanner.read(v))
+		{
+			n = std::max(n, std::max(u, v));
+		}
+		return n + 1;
+	}
+
+	/** reads a graph in edge list format */
 	template<typename Graph>
 	Graph readEdgeList(std::string const &filename)
 	{
-		size_t n = get_size(filename, true);
+		Mapped_File file(filename);
+		uint64_t n = get_size_edgelist(file);
 
-		if(n > std::numeric_limits<VertexID>::max())
+		if(n > std::numeric_limits<typename Graph::VertexID>::max())
 		{
 			throw std::range_error(std::string("Graph has too many vertices: ") + filename);
 		}
 
 		Graph g(n);
 
-		std::ifstream f(filename);
-
+		Scanner scanner(file);
 		uint64_t u, v;
-		while(f >> u >> v)
+		while(scanner.read(u) && scanner.read(v))
 		{
 			g.set_edge(u, v);
 		}
@@ -48,39 +152,29 @@ namespace Graph
 	template<typename Graph>
 	Graph readMetis(std::string const &filename)
 	{
-		std::ifstream f(filename);
-		std::string line;
-		std::istringstream linestream;
+		Mapped_File file(filename);
+		Scanner scanner(file);
 
-		if(!f)
-		{
-			throw std::runtime_error(std::string("Error opening file: ") + filename);
-		}
-
-		while(std::getline(f, line))
-		{
-			if(line[0] != '%') {break;}
-		}
-		if(!f)
+		while(scanner.is_comment()) {scanner.next_line();}
+		uint64_t n, ignored, fmt = 0, vertexweights = 0;
+		if(!scanner.read_in_line(n) || !scanner.read_in_line(ignored))
 		{
 			throw std::runtime_error(std::string("Premature end of file: ") + filename);
 		}
 
-		uint64_t n, ignored, fmt = 0, vertexweights = 0;
 		bool edgeweight = false;
-
-		linestream.str(line);
-		linestream >> n >> ignored;
-		if(linestream >> fmt)
+		if(scanner.read_in_line(fmt))
 		{
 			if(fmt >= 10)
 			{
-				linestream >> vertexweights;
+				// number of vertex weights, defaults to one
+				if(!scanner.read_in_line(vertexweights)) {vertexweights = 1;}
 			}
 			edgeweight = (fmt == 1 || fmt == 11);
 		}
+		scanner.next_line();
 
-		if(n > std::numeric_limits<VertexID>::max())
+		if(n > std::numeric_limits<typename Graph::VertexID>::max())
 		{
 			throw std::range_error(std::string("Graph has too many vertices: ") + filename);
 		}
@@ -88,19 +182,21 @@ namespace Graph
 		Graph g(n);
 		uint64_t u = 0;
 		uint64_t v;
-		while(std::getline(f, line))
+		for(; !scanner.at_end() && u < n; scanner.next_line())
 		{
-			if(line[0] == '%') {continue;}
-			linestream.clear();
-			linestream.str(line);
+			if(scanner.is_comment()) {continue;}
 
 			u++;
 
-			for(uint64_t i = 0; i < vertexweights; i++) {linestream >> ignored;}
-			while(linestream >> v)
+			for(uint64_t i = 0; i < vertexweights; i++) {scanner.read_in_line(ignored);}
+			while(scanner.read_in_line(v))
 			{
+				if(v == 0 || v > n)
+				{
+					throw std::range_error(std::string("Invalid vertex id in line of vertex ") + std::to_string(u) + ": " + filename);
+				}
 				g.set_edge(u - 1, v - 1);
-				if(edgeweight) {linestream >> ignored;}
+				if(edgeweight) {scanner.read_in_line(ignored);}
 			}
 		}
 
@@ -108,10 +204,176 @@ namespace Graph
 		return g;
 	}
 
+	/** Header of the binary graph cache (.bgraph), followed by n rows of row_length Packed words in Matrix layout */
+	struct Binary_Header
+	{
+		static constexpr uint64_t magic_value = 0x3148504152474246; // "FBGRAPH1"
+		static constexpr uint32_t version_value = 1;
+
+		uint64_t magic;
+		uint32_t version;
+		uint32_t packed_size;
+		uint64_t edgelist;
+		uint64_t n;
+		uint64_t row_length;
+		/* size and modification time of the text file the cache was created from */
+		uint64_t source_size;
+		uint64_t source_mtime;
+		uint64_t checksum;
+	};
+	static_assert(sizeof(Binary_Header) % sizeof(Packed) == 0, "Binary_Header must be a multiple of Packed");
+
+	/** Largest cache file written, graphs with larger adjacency matrices are always parsed */
+	constexpr size_t binary_cache_max_size = size_t(1) << 28;
+
+	/** Name of the binary cache belonging to a text file */
+	inline std::string binary_filename(std::string const &filename)
+	{
+		return filename + ".bgraph";
+	}
+
+	/** Running checksum over rows as stored in the binary cache */
+	inline uint64_t binary_checksum(uint64_t checksum, Packed const *data, size_t words)
+	{
+		for(size_t i = 0; i < words; i++)
+		{
+			checksum = (checksum ^ static_cast<uint64_t>(data[i])) * 0x100000001b3;
+			checksum ^= checksum >> 29;
+		}
+		return checksum;
+	}
+
+	/** Reads the rows of an up-to-date binary cache, open() fails if the cache is missing, stale or truncated */
+	class Binary_Reader
+	{
+	private:
+		int fd;
+		Binary_Header h;
+
+	public:
+		Binary_Reader() : fd(-1) {;}
+		~Binary_Reader();
+		Binary_Reader(Binary_Reader const &) = delete;
+		Binary_Reader &operator=(Binary_Reader const &) = delete;
+
+		bool open(std::string const &filename, bool edgelist);
+		Binary_Header const &header() const {return h;}
+		bool read(Packed *data, size_t words);
+	};
+
+	/** Writes a binary cache to a temporary file which replaces the cache on commit() */
+	class Binary_Writer
+	{
+	private:
+		int fd;
+		std::string filename;
+		std::string tmp_filename;
+		Binary_Header h;
+
+	public:
+		Binary_Writer(std::string const &filename, bool edgelist, uint64_t n, uint64_t row_length);
+		~Binary_Writer();
+		Binary_Writer(Binary_Writer const &) = delete;
+		Binary_Writer &operator=(Binary_Writer const &) = delete;
+
+		bool write(Packed const *data, size_t words);
+		bool commit(uint64_t checksum);
+	};
+
+	/** Does the graph give writable access to its rows in Matrix layout? */
+	template<typename Graph, typename = void>
+	struct has_row_data : std::false_type {};
+
+	template<typename Graph>
+	struct has_row_data<Graph, std::void_t<decltype(std::declval<Graph &>().get_row_data())>> : std::true_type {};
+
+	/** Fills the empty graph @a g from the binary cache, returns false if the checksum does not match */
+	template<typename Graph>
+	bool readBinary(Binary_Reader &reader, Graph &g)
+	{
+		using VertexID = typename Graph::VertexID;
+		Binary_Header const &header = reader.header();
+		uint64_t checksum = 0;
+
+		if constexpr(has_row_data<Graph>::value)
+		{
+			if(header.row_length == g.get_row_length())
+			{
+				// single read straight into the rows
+				Packed *data = g.get_row_data();
+				size_t words = header.n * header.row_length;
+				if(!reader.read(data, words)) {return false;}
+				checksum = binary_checksum(checksum, data, words);
+				return checksum == header.checksum;
+			}
+		}
+
+		// edge by edge for other layouts and rows padded to a different length
+		std::vector<Packed> row(header.row_length);
+		for(VertexID u = 0; u < header.n; u++)
+		{
+			if(!reader.read(row.data(), row.size())) {return false;}
+			checksum = binary_checksum(checksum, row.data(), row.size());
+			for(size_t i = u / Packed_Bits; i < row.size(); i++)
+			{
+				for(Packed ui = row[i]; ui; ui &= ~(Packed(1) << PACKED_CTZ(ui)))
+				{
+					VertexID v = PACKED_CTZ(ui) + i * Packed_Bits;
+					if(u < v) {g.set_edge(u, v);}
+				}
+			}
+		}
+
+		return checksum == header.checksum;
+	}
+
+	/** Writes the binary cache for the text file @a filename, failures are ignored as the cache is optional */
+	template<typename Graph>
+	void writeBinary(std::string const &filename, bool edgelist, Graph const &g)
+	{
+		using VertexID = typename Graph::VertexID;
+		size_t row_length = g.get_row_length();
+		if(static_cast<size_t>(g.size()) * row_length * sizeof(Packed) > binary_cache_max_size) {return;}
+
+		Binary_Writer writer(filename, edgelist, g.size(), row_length);
+		uint64_t checksum = 0;
+		for(VertexID u = 0; u < g.size(); u++)
+		{
+			Packed const *row = g.get_row(u);
+			checksum = binary_checksum(checksum, row, row_length);
+			if(!writer.write(row, row_length)) {return;}
+		}
+		writer.commit(checksum);
+	}
+
+	/** Reads a graph from its binary cache if it is up to date, otherwise parses the text file and creates the cache */
+	template<typename Graph>
+	Graph readGraph(std::string const &filename, bool edgelist, bool use_cache = true)
+	{
+		if(use_cache)
+		{
+			Binary_Reader reader;
+			if(reader.open(filename, edgelist) && reader.header().n <= std::numeric_limits<typename Graph::VertexID>::max())
+			{
+				Graph g(reader.header().n);
+				if(readBinary(reader, g))
+				{
+					g.verify();
+					return g;
+				}
+			}
+		}
+
+		Graph g = edgelist ? readEdgeList<Graph>(filename) : readMetis<Graph>(filename);
+		if(use_cache) {writeBinary(filename, edgelist, g);}
+		return g;
+	}
+
 	/** Writes a graph in METIS format */
 	template<typename Graph>
 	void writeMetis(std::string const &filename, Graph const &g)
 	{
+		using VertexID = typename Graph::VertexID;
 		g.verify();
 		std::ofstream f(filename);
 		if(!f)
@@ -137,6 +399,7 @@ namespace Graph
 	template<typename Graph>
 	static void writeDot(std::string const &filename, Graph const &g)
 	{
+		using VertexID = typename Graph::VertexID;
 		g.verify();
 		std::ofstream f(filename);
 		if(!f)
@@ -159,6 +422,7 @@ namespace Graph
 	template<typename Graph, typename Graph_Edits>
 	void writeDotCombined(std::string const &filename, Graph const &g, Graph_Edits const &edits, Graph const &g_orig)
 	{
+		using VertexID = typename Graph::VertexID;
 		assert(g.size() == edits.size() && g.size() == g_orig.size());
 		g.verify();
 		edits.verify();
@@ -205,8 +469,9 @@ namespace Graph
 	 * @param seed The random seed to use. 0 generates the identity permutation.
 	 */
 	template <typename Graph>
-	std::vector<VertexID> generate_permutation(const Graph &g, size_t seed)
+	std::vector<typename Graph::VertexID> generate_permutation(const Graph &g, size_t seed)
 	{
+		using VertexID = typename Graph::VertexID;
 		std::vector<VertexID> result(g.size());
 		for (VertexID u = 0; u < g.size(); ++u)
 		{
@@ -223,8 +488,9 @@ namespace Graph
 	}
 
 	template <typename Graph>
-	Graph apply_permutation(const Graph &g, const std::vector<VertexID> &permutation)
+	Graph apply_permutation(const Graph &g, const std::vector<typename Graph::VertexID> &permutation)
 	{
+		using VertexID = typename Graph::VertexID;
 		Graph result(g.size());
 
 		for (VertexID u = 0; u < g.size(); ++u)
@@ -238,7 +504,72 @@ namespace Graph
 		return result;
 	}
 
-	std::vector<VertexID> invert_permutation(const std::vector<VertexID> &permutation);
+	template <typename VertexID>
+	std::vector<VertexID> invert_permutation(const std::vector<VertexID> &permutation)
+	{
+		std::vector<VertexID> result(permutation.size());
+
+		for (size_t u = 0; u < permutation.size(); ++u)
+		{
+			result[permutation[u]] = u;
+		}
+
+		return result;
+	}
+
+	/** Splits the vertices of @a g into connected components, each component is sorted by vertex id */
+	template <typename Graph>
+	std::vector<std::vector<typename Graph::VertexID>> connected_components(const Graph &g)
+	{
+		using VertexID = typename Graph::VertexID;
+		std::vector<std::vector<VertexID>> result;
+		std::vector<bool> visited(g.size(), false);
+
+		for (VertexID s = 0; s < g.size(); ++s)
+		{
+			if (visited[s]) {continue;}
+			visited[s] = true;
+			std::vector<VertexID> component{s};
+			for (size_t i = 0; i < component.size(); ++i)
+			{
+				g.for_neighbours(component[i], [&](VertexID v) {
+					if (!visited[v])
+					{
+						visited[v] = true;
+						component.push_back(v);
+					}
+					return false;
+				});
+			}
+			std::sort(component.begin(), component.end());
+			result.push_back(std::move(component));
+		}
+
+		return result;
+	}
+
+	/** The subgraph of @a g induced by the sorted vertex list @a vertices, vertex i of the result is vertices[i] */
+	template <typename Graph>
+	Graph induced_subgraph(const Graph &g, const std::vector<typename Graph::VertexID> &vertices)
+	{
+		using VertexID = typename Graph::VertexID;
+		assert(std::is_sorted(vertices.begin(), vertices.end()));
+		Graph result(vertices.size());
+
+		for (VertexID i = 0; i < vertices.size(); ++i)
+		{
+			g.for_neighbours(vertices[i], [&](VertexID v) {
+				auto it = std::lower_bound(vertices.begin(), vertices.end(), v);
+				if (it != vertices.end() && *it == v && vertices[i] < v)
+				{
+					result.set_edge(i, it - vertices.begin());
+				}
+				return false;
+			});
+		}
+
+		return result;
+	}
 }
 
 #endif
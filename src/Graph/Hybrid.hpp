@@ -0,0 +1,350 @@
+#ifndef GRAPH_HYBRID_HPP
+#define GRAPH_HYBRID_HPP
+
+#include <assert.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "../config.hpp"
+
+#include "Graph.hpp"
+#include "Row_Kernels.hpp"
+
+namespace Graph
+{
+	/** Adjacency structure for large sparse graphs.
+	 * Low-degree vertices store a sorted neighbour list, vertices whose list would take more space than a matrix row get a bitset row.
+	 * Rows of sparse vertices are materialized on demand into a small set-associative cache, so get_row() keeps the Matrix interface.
+	 * The pointer returned by get_row() stays valid for the next cache_ways - 1 calls to get_row() on the same object.
+	 * Only the adjacency structure is sparse, consumers keeping per pair data (e.g. Counter_Matrix) still need memory quadratic in the number of vertices.
+	 */
+	template<typename _VertexID, size_t _fixed_row_length = 0>
+	class Hybrid_Impl
+	{
+	public:
+		static constexpr char const *name = "Hybrid";
+		/* row length known at compile time, see Matrix_Impl */
+		static constexpr size_t fixed_row_length = _fixed_row_length;
+		/* get_row() fills a shared cache, so the graph must not be read from several threads */
+		static constexpr bool concurrent_reads = false;
+		using VertexID = _VertexID;
+
+	private:
+		static constexpr size_t no_row = std::numeric_limits<size_t>::max();
+		/* a search holds at most the rows of a path and its current vertex, so these never evict each other */
+		static constexpr size_t cache_ways = 8;
+		static constexpr size_t cache_sets = 16;
+		static constexpr size_t cache_size = cache_ways * cache_sets;
+
+		VertexID n;
+		size_t row_length;
+		size_t num_edges;
+		/* a sparse vertex is promoted once its degree exceeds dense_threshold and demoted once it drops below half of it */
+		size_t dense_threshold;
+
+		std::vector<std::vector<VertexID>> neighbours;
+		std::vector<size_t> dense_row;
+		std::vector<Packed> dense_rows;
+		std::vector<size_t> free_rows;
+
+		mutable std::vector<Packed> cache_rows;
+		mutable std::vector<size_t> cache_tag;
+		mutable std::vector<size_t> cache_used;
+		mutable size_t cache_clock = 0;
+
+	public:
+		Hybrid_Impl(VertexID n) : n(n), row_length(get_row_length(n)), num_edges(0), dense_threshold(std::max<size_t>(1, row_length * sizeof(Packed) / sizeof(VertexID))), neighbours(n), dense_row(n, no_row), cache_rows(cache_size * row_length, 0), cache_tag(cache_size, no_row), cache_used(cache_size, 0)
+		{
+		}
+
+		VertexID size() const
+		{
+			return n;
+		}
+
+		size_t count_edges() const
+		{
+			return num_edges;
+		}
+
+		bool has_edge(VertexID u, VertexID v) const
+		{
+			assert(u != v);
+			assert(u < n && v < n);
+
+			if(dense_row[u] != no_row) {return test_bit(u, v);}
+			if(dense_row[v] != no_row) {return test_bit(v, u);}
+			if(neighbours[u].size() > neighbours[v].size()) {std::swap(u, v);}
+			return std::binary_search(neighbours[u].begin(), neighbours[u].end(), v);
+		}
+
+		void set_edge(VertexID u, VertexID v)
+		{
+			assert(u != v);
+			assert(u < n && v < n);
+
+			if(has_edge(u, v)) {return;}
+			insert_half(u, v);
+			insert_half(v, u);
+			num_edges++;
+		}
+
+		void clear_edge(VertexID u, VertexID v)
+		{
+			assert(u != v);
+			assert(u < n && v < n);
+
+			if(!has_edge(u, v)) {return;}
+			erase_half(u, v);
+			erase_half(v, u);
+			num_edges--;
+		}
+
+		void toggle_edge(VertexID u, VertexID v)
+		{
+			if(has_edge(u, v)) {clear_edge(u, v);}
+			else {set_edge(u, v);}
+		}
+
+		size_t degree(VertexID u) const
+		{
+			if(dense_row[u] == no_row) {return neighbours[u].size();}
+
+			return Row::popcount(dense_rows.data() + dense_row[u], row_length);
+		}
+
+		template <typename F>
+		bool for_neighbours(VertexID u, F callback) const {
+			if(dense_row[u] == no_row)
+			{
+				for(VertexID v: neighbours[u])
+				{
+					if(callback(v)) return true;
+				}
+				return false;
+			}
+
+			Packed const *urow = dense_rows.data() + dense_row[u];
+			for(size_t i = 0; i < row_length; i++)
+			{
+				for(Packed ui = urow[i]; ui; ui &= ~(Packed(1) << PACKED_CTZ(ui)))
+				{
+					VertexID v = PACKED_CTZ(ui) + i * Packed_Bits;
+					if (callback(v)) return true;
+				}
+			}
+
+			return false;
+		}
+
+		std::vector<VertexID> const get_neighbours(VertexID u) const
+		{
+			if(dense_row[u] == no_row) {return neighbours[u];}
+
+			std::vector<VertexID> result;
+			for_neighbours(u, [&result](VertexID v) {
+				result.push_back(v);
+				return false;
+			});
+			return result;
+		}
+
+		Packed const *get_row(VertexID u) const
+		{
+			if(dense_row[u] != no_row) {return dense_rows.data() + dense_row[u];}
+
+			// least recently used way of the set of u, unless u is cached already
+			size_t const set = (u % cache_sets) * cache_ways;
+			size_t slot = set;
+			for(size_t way = set; way < set + cache_ways; way++)
+			{
+				if(cache_tag[way] == u) {slot = way; break;}
+				if(cache_used[way] < cache_used[slot]) {slot = way;}
+			}
+			cache_used[slot] = ++cache_clock;
+
+			Packed *row = cache_rows.data() + slot * row_length;
+			if(cache_tag[slot] != u)
+			{
+				if(cache_tag[slot] != no_row) {evict(slot);}
+				for(VertexID v: neighbours[u])
+				{
+					row[v / Packed_Bits] |= Packed(1) << (v % Packed_Bits);
+				}
+				cache_tag[slot] = u;
+			}
+			return row;
+		}
+
+		static size_t get_row_length(VertexID graph_size)
+		{
+			if constexpr (fixed_row_length > 0)
+			{
+				assert(graph_size <= fixed_row_length * Packed_Bits);
+				return fixed_row_length;
+			}
+			return (graph_size + Packed_Bits - 1) / Packed_Bits;
+		}
+
+		size_t get_row_length() const
+		{
+			if constexpr (fixed_row_length > 0) {return fixed_row_length;}
+			return row_length;
+		}
+
+		static std::vector<Packed> alloc_rows(VertexID graph_size, size_t rows)
+		{
+			return std::vector<Packed>(rows * get_row_length(graph_size), 0);
+		}
+
+		std::vector<Packed> alloc_rows(size_t rows) const
+		{
+			return std::vector<Packed>(rows * row_length, 0);
+		}
+
+		bool verify() const
+		{
+			bool valid = true;
+			size_t count = 0;
+			for(VertexID u = 0; u < n; u++)
+			{
+				if(dense_row[u] == no_row && !std::is_sorted(neighbours[u].begin(), neighbours[u].end()))
+				{
+					std::cerr << "[hybrid] neighbours of " << +u << " not sorted\n";
+					valid = false;
+				}
+				for_neighbours(u, [&](VertexID v) {
+					count++;
+					if(!has_edge(v, u))
+					{
+						std::cerr << "[hybrid] " << +u << " -> " << +v << " but not " << +v << " -> " << +u << "\n";
+						valid = false;
+					}
+					return false;
+				});
+			}
+			if(count != 2 * num_edges)
+			{
+				std::cerr << "[hybrid] counted " << count / 2 << " edges, expected " << num_edges << "\n";
+				valid = false;
+			}
+			if(!valid) {abort();}
+			return valid;
+		}
+
+		void clear()
+		{
+			num_edges = 0;
+			neighbours = decltype(neighbours)(n);
+			dense_row = decltype(dense_row)(n, no_row);
+			dense_rows.clear();
+			free_rows.clear();
+			std::fill(cache_rows.begin(), cache_rows.end(), 0);
+			std::fill(cache_tag.begin(), cache_tag.end(), no_row);
+			std::fill(cache_used.begin(), cache_used.end(), 0);
+		}
+
+	private:
+		bool test_bit(VertexID u, VertexID v) const
+		{
+			return dense_rows[dense_row[u] + v / Packed_Bits] & (Packed(1) << (v % Packed_Bits));
+		}
+
+		/** Returns a cached row to zero, without touching more words than the evicted vertex has neighbours */
+		void evict(size_t slot) const
+		{
+			Packed *row = cache_rows.data() + slot * row_length;
+			VertexID old = cache_tag[slot];
+			if(dense_row[old] == no_row && neighbours[old].size() < row_length)
+			{
+				for(VertexID v: neighbours[old]) {row[v / Packed_Bits] = 0;}
+			}
+			else
+			{
+				std::fill(row, row + row_length, 0);
+			}
+			cache_tag[slot] = no_row;
+		}
+
+		/** Pointer to the cached row of u, or nullptr if u is not cached */
+		Packed *cached_row(VertexID u)
+		{
+			size_t const set = (u % cache_sets) * cache_ways;
+			for(size_t way = set; way < set + cache_ways; way++)
+			{
+				if(cache_tag[way] == u) {return cache_rows.data() + way * row_length;}
+			}
+			return nullptr;
+		}
+
+		void insert_half(VertexID u, VertexID v)
+		{
+			if(dense_row[u] != no_row)
+			{
+				dense_rows[dense_row[u] + v / Packed_Bits] |= Packed(1) << (v % Packed_Bits);
+				return;
+			}
+
+			auto &list = neighbours[u];
+			list.insert(std::lower_bound(list.begin(), list.end(), v), v);
+			if(Packed *row = cached_row(u)) {row[v / Packed_Bits] |= Packed(1) << (v % Packed_Bits);}
+			if(list.size() > dense_threshold) {promote(u);}
+		}
+
+		void erase_half(VertexID u, VertexID v)
+		{
+			if(dense_row[u] == no_row)
+			{
+				auto &list = neighbours[u];
+				list.erase(std::lower_bound(list.begin(), list.end(), v));
+				if(Packed *row = cached_row(u)) {row[v / Packed_Bits] &= ~(Packed(1) << (v % Packed_Bits));}
+				return;
+			}
+
+			dense_rows[dense_row[u] + v / Packed_Bits] &= ~(Packed(1) << (v % Packed_Bits));
+			if(degree(u) < dense_threshold / 2) {demote(u);}
+		}
+
+		void promote(VertexID u)
+		{
+			if(Packed *row = cached_row(u)) {evict((row - cache_rows.data()) / row_length);}
+
+			size_t offset;
+			if(free_rows.empty())
+			{
+				offset = dense_rows.size();
+				dense_rows.resize(offset + row_length, 0);
+			}
+			else
+			{
+				offset = free_rows.back();
+				free_rows.pop_back();
+			}
+
+			for(VertexID v: neighbours[u])
+			{
+				dense_rows[offset + v / Packed_Bits] |= Packed(1) << (v % Packed_Bits);
+			}
+			dense_row[u] = offset;
+			std::vector<VertexID>().swap(neighbours[u]);
+		}
+
+		void demote(VertexID u)
+		{
+			std::vector<VertexID> list = get_neighbours(u);
+			size_t offset = dense_row[u];
+			std::fill(dense_rows.begin() + offset, dense_rows.begin() + offset + row_length, 0);
+			free_rows.push_back(offset);
+			dense_row[u] = no_row;
+			neighbours[u] = std::move(list);
+		}
+	};
+
+	using Hybrid = Hybrid_Impl<VertexID>;
+}
+
+#endif
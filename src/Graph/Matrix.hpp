@@ -3,19 +3,30 @@
 
 #include <assert.h>
 
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 
 #include "../config.hpp"
 
 #include "Graph.hpp"
+#include "Row_Kernels.hpp"
 
 namespace Graph
 {
-	class Matrix
+	/** Adjacency matrix with one bitset row per vertex.
+	 * With _fixed_row_length > 0 the row length is a compile-time constant, so all loops over rows can be unrolled.
+	 * Such a matrix holds graphs with up to _fixed_row_length * Packed_Bits vertices, shorter rows are padded with zeros.
+	 */
+	template<typename _VertexID, size_t _fixed_row_length = 0>
+	class Matrix_Impl
 	{
 	public:
 		static constexpr char const *name = "Matrix";
+		static constexpr size_t fixed_row_length = _fixed_row_length;
+		/* all const methods may be called from several threads at once */
+		static constexpr bool concurrent_reads = true;
+		using VertexID = _VertexID;
 
 	private:
 		VertexID n;
@@ -23,7 +34,7 @@ namespace Graph
 		std::vector<Packed> matrix;
 
 	public:
-		Matrix(VertexID n) : n(n), row_length((n + Packed_Bits - 1) / Packed_Bits), matrix(n * row_length, 0)
+		Matrix_Impl(VertexID n) : n(n), row_length(get_row_length(n)), matrix(n * row_length, 0)
 		{
 		}
 
@@ -34,12 +45,7 @@ namespace Graph
 
 		size_t count_edges() const
 		{
-			size_t count = 0;
-			for(auto const &elem: matrix)
-			{
-				count += PACKED_POP(elem);
-			}
-			return count / 2;
+			return Row::popcount(matrix.data(), matrix.size()) / 2;
 		}
 
 		bool has_edge(VertexID u, VertexID v) const
@@ -47,7 +53,7 @@ namespace Graph
 			assert(u != v);
 			assert(u < n && v < n);
 
-			return (matrix.data() + row_length * u)[v / Packed_Bits] & (Packed(1) << (v % Packed_Bits));
+			return (matrix.data() + get_row_length() * u)[v / Packed_Bits] & (Packed(1) << (v % Packed_Bits));
 		}
 
 		void set_edge(VertexID u, VertexID v)
@@ -55,8 +61,8 @@ namespace Graph
 			assert(u != v);
 			assert(u < n && v < n);
 
-			(matrix.data() + row_length * u)[v / Packed_Bits] |= Packed(1) << (v % Packed_Bits);
-			(matrix.data() + row_length * v)[u / Packed_Bits] |= Packed(1) << (u % Packed_Bits);
+			(matrix.data() + get_row_length() * u)[v / Packed_Bits] |= Packed(1) << (v % Packed_Bits);
+			(matrix.data() + get_row_length() * v)[u / Packed_Bits] |= Packed(1) << (u % Packed_Bits);
 		}
 
 		void clear_edge(VertexID u, VertexID v)
@@ -64,8 +70,8 @@ namespace Graph
 			assert(u != v);
 			assert(u < n && v < n);
 
-			(matrix.data() + row_length * u)[v / Packed_Bits] &= ~(Packed(1) << (v % Packed_Bits));
-			(matrix.data() + row_length * v)[u / Packed_Bits] &= ~(Packed(1) << (u % Packed_Bits));
+			(matrix.data() + get_row_length() * u)[v / Packed_Bits] &= ~(Packed(1) << (v % Packed_Bits));
+			(matrix.data() + get_row_length() * v)[u / Packed_Bits] &= ~(Packed(1) << (u % Packed_Bits));
 		}
 
 		void toggle_edge(VertexID u, VertexID v)
@@ -73,19 +79,13 @@ namespace Graph
 			assert(u != v);
 			assert(u < n && v < n);
 
-			(matrix.data() + row_length * u)[v / Packed_Bits] ^= Packed(1) << (v % Packed_Bits);
-			(matrix.data() + row_length * v)[u / Packed_Bits] ^= Packed(1) << (u % Packed_Bits);
+			(matrix.data() + get_row_length() * u)[v / Packed_Bits] ^= Packed(1) << (v % Packed_Bits);
+			(matrix.data() + get_row_length() * v)[u / Packed_Bits] ^= Packed(1) << (u % Packed_Bits);
 		}
 
 		size_t degree(VertexID u) const
 		{
-			Packed const *urow = get_row(u);
-			size_t deg = 0;
-			for(size_t i = 0; i < get_row_length(); i++)
-			{
-				deg += PACKED_POP(urow[i]);
-			}
-			return deg;
+			return Row::popcount(get_row(u), get_row_length());
 		}
 
 		template <typename F>
@@ -116,16 +116,28 @@ namespace Graph
 
 		Packed const *get_row(VertexID u) const
 		{
-			return matrix.data() + row_length * u;
+			return matrix.data() + get_row_length() * u;
+		}
+
+		/** Writable access to all rows, used to fill the matrix from a binary file. The rows have to stay symmetric */
+		Packed *get_row_data()
+		{
+			return matrix.data();
 		}
 
 		static size_t get_row_length(VertexID graph_size)
 		{
+			if constexpr (fixed_row_length > 0)
+			{
+				assert(graph_size <= fixed_row_length * Packed_Bits);
+				return fixed_row_length;
+			}
 			return (graph_size + Packed_Bits - 1) / Packed_Bits;
 		}
 
 		size_t get_row_length() const
 		{
+			if constexpr (fixed_row_length > 0) {return fixed_row_length;}
 			return row_length;
 		}
 
@@ -136,7 +148,7 @@ namespace Graph
 
 		std::vector<Packed> alloc_rows(size_t rows) const
 		{
-			return std::vector<Packed>(rows * row_length, 0);
+			return std::vector<Packed>(rows * get_row_length(), 0);
 		}
 
 		bool verify() const
@@ -165,9 +177,11 @@ namespace Graph
 
 		void clear()
 		{
-			matrix = decltype(matrix)(matrix.size(), 0);
+			std::fill(matrix.begin(), matrix.end(), 0);
 		}
 	};
+
+	using Matrix = Matrix_Impl<VertexID>;
 }
 
 #endif
@@ -0,0 +1,129 @@
+#ifndef GRAPH_PAIR_MAP_HPP
+#define GRAPH_PAIR_MAP_HPP
+
+#include <assert.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../config.hpp"
+
+namespace Graph
+{
+	/** Map from the few vertex pairs in use to 32 bit values, in a hash table with linear probing.
+	 * Lookups, insertions and deletions take expected constant time; deletions shift the following slots back instead of leaving tombstones.
+	 * The table doubles before it gets more than half full; memory and copies cost 12 bytes per slot instead of a value for every pair as in Value_Matrix.
+	 */
+	class Pair_Map
+	{
+	public:
+		static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+	private:
+		struct Slot
+		{
+			/* the pair with u < v, u == v marks an empty slot */
+			uint32_t u = 0, v = 0;
+			uint32_t value = 0;
+		};
+
+		std::vector<Slot> slots;
+		size_t num_pairs = 0;
+		unsigned shift = 64;
+
+	public:
+		/** The value of the pair (x, y), none if it has none */
+		size_t find(size_t x, size_t y) const
+		{
+			if(slots.empty()) {return none;}
+			Slot const &slot = slots[slot_of(std::min(x, y), std::max(x, y))];
+			return slot.u != slot.v ? slot.value : none;
+		}
+
+		/** Sets the value of the pair (x, y), which may already have one */
+		void set(size_t x, size_t y, size_t value)
+		{
+			assert(value < std::numeric_limits<uint32_t>::max());
+			if(2 * (num_pairs + 1) > slots.size()) {grow();}
+			Slot &slot = slots[slot_of(std::min(x, y), std::max(x, y))];
+			if(slot.u == slot.v) {num_pairs++;}
+			slot = Slot{static_cast<uint32_t>(std::min(x, y)), static_cast<uint32_t>(std::max(x, y)), static_cast<uint32_t>(value)};
+		}
+
+		/** Removes the pair (x, y), which must have a value */
+		void erase(size_t x, size_t y)
+		{
+			size_t const mask = slots.size() - 1;
+			size_t hole = slot_of(std::min(x, y), std::max(x, y));
+			assert(slots[hole].u != slots[hole].v);
+			for(size_t j = (hole + 1) & mask; slots[j].u != slots[j].v; j = (j + 1) & mask)
+			{
+				// the pair in j may fill the hole unless its home lies cyclically in (hole, j]
+				size_t const home = home_of(slots[j].u, slots[j].v);
+				bool const stays = hole < j ? (hole < home && home <= j) : (hole < home || home <= j);
+				if(!stays)
+				{
+					slots[hole] = slots[j];
+					hole = j;
+				}
+			}
+			slots[hole] = Slot();
+			num_pairs--;
+		}
+
+		/** Replaces each value i by new_value(i) */
+		template<typename F>
+		void renumber(F new_value)
+		{
+			for(Slot &slot : slots)
+			{
+				if(slot.u != slot.v) {slot.value = static_cast<uint32_t>(new_value(slot.value));}
+			}
+		}
+
+		/** Removes all pairs, keeps the capacity */
+		void clear()
+		{
+			if(num_pairs == 0) {return;}
+			std::fill(slots.begin(), slots.end(), Slot());
+			num_pairs = 0;
+		}
+
+		size_t size() const
+		{
+			return num_pairs;
+		}
+
+	private:
+		size_t home_of(uint32_t u, uint32_t v) const
+		{
+			return static_cast<size_t>(((uint64_t(u) << 32 | v) * uint64_t(0x9E3779B97F4A7C15)) >> shift);
+		}
+
+		/** The slot holding the pair (u, v) with u < v, or the empty slot where it would be inserted */
+		size_t slot_of(size_t u, size_t v) const
+		{
+			size_t const mask = slots.size() - 1;
+			size_t i = home_of(u, v);
+			while(slots[i].u != slots[i].v && (slots[i].u != u || slots[i].v != v)) {i = (i + 1) & mask;}
+			return i;
+		}
+
+		void grow()
+		{
+			std::vector<Slot> old(slots.empty() ? 16 : 2 * slots.size());
+			old.swap(slots);
+			shift = 64;
+			for(size_t size = slots.size(); size > 1; size /= 2) {shift--;}
+
+			for(Slot const &slot : old)
+			{
+				if(slot.u != slot.v) {slots[slot_of(slot.u, slot.v)] = slot;}
+			}
+		}
+	};
+}
+
+#endif
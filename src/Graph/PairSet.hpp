@@ -0,0 +1,253 @@
+#ifndef GRAPH_PAIR_SET_HPP
+#define GRAPH_PAIR_SET_HPP
+
+#include <assert.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "../config.hpp"
+
+#include "Graph.hpp"
+#include "Row_Kernels.hpp"
+
+namespace Graph
+{
+	/** Graph interface for the few vertex pairs marked as edited.
+	 * Only vertices incident to a marked pair own a bitset row, all other vertices share an empty row.
+	 * Memory and copies therefore cost O(n) for the row index plus one row per marked vertex instead of a full matrix.
+	 * The pointer returned by get_row() is only valid until the next set_edge() or toggle_edge().
+	 * clear() only visits the rows in use, so scratch sets that are cleared at every search node cost O(marked vertices) instead of O(n) per node.
+	 */
+	template<typename _VertexID, size_t _fixed_row_length = 0>
+	class Pair_Set_Impl
+	{
+	public:
+		static constexpr char const *name = "Pair_Set";
+		/* row length known at compile time, see Matrix_Impl */
+		static constexpr size_t fixed_row_length = _fixed_row_length;
+		/* const methods only read the rows */
+		static constexpr bool concurrent_reads = true;
+		using VertexID = _VertexID;
+
+	private:
+		/* rows[0, row_length) is the shared empty row */
+		static constexpr size_t empty_row = 0;
+
+		VertexID n;
+		size_t row_length;
+		size_t num_edges;
+
+		std::vector<size_t> row;
+		std::vector<VertexID> row_degree;
+		std::vector<Packed> rows;
+		std::vector<size_t> free_rows;
+		/* the vertex each row was last handed to, indexed by row number */
+		std::vector<VertexID> row_owner;
+
+	public:
+		Pair_Set_Impl(VertexID n) : n(n), row_length(get_row_length(n)), num_edges(0), row(n, empty_row), row_degree(n, 0), rows(row_length, 0), row_owner(1, 0)
+		{
+		}
+
+		VertexID size() const
+		{
+			return n;
+		}
+
+		size_t count_edges() const
+		{
+			return num_edges;
+		}
+
+		bool has_edge(VertexID u, VertexID v) const
+		{
+			assert(u != v);
+			assert(u < n && v < n);
+
+			return rows[row[u] + v / Packed_Bits] & (Packed(1) << (v % Packed_Bits));
+		}
+
+		void set_edge(VertexID u, VertexID v)
+		{
+			assert(u != v);
+			assert(u < n && v < n);
+
+			if(has_edge(u, v)) {return;}
+			insert_half(u, v);
+			insert_half(v, u);
+			num_edges++;
+		}
+
+		void clear_edge(VertexID u, VertexID v)
+		{
+			assert(u != v);
+			assert(u < n && v < n);
+
+			if(!has_edge(u, v)) {return;}
+			erase_half(u, v);
+			erase_half(v, u);
+			num_edges--;
+		}
+
+		void toggle_edge(VertexID u, VertexID v)
+		{
+			if(has_edge(u, v)) {clear_edge(u, v);}
+			else {set_edge(u, v);}
+		}
+
+		size_t degree(VertexID u) const
+		{
+			return row_degree[u];
+		}
+
+		template <typename F>
+		bool for_neighbours(VertexID u, F callback) const {
+			if(row[u] == empty_row) {return false;}
+
+			Packed const *urow = get_row(u);
+			for(size_t i = 0; i < row_length; i++)
+			{
+				for(Packed ui = urow[i]; ui; ui &= ~(Packed(1) << PACKED_CTZ(ui)))
+				{
+					VertexID v = PACKED_CTZ(ui) + i * Packed_Bits;
+					if (callback(v)) return true;
+				}
+			}
+
+			return false;
+		}
+
+		std::vector<VertexID> const get_neighbours(VertexID u) const
+		{
+			std::vector<VertexID> neighbours;
+			for_neighbours(u, [&neighbours](VertexID v) {
+				neighbours.push_back(v);
+				return false;
+			});
+			return neighbours;
+		}
+
+		Packed const *get_row(VertexID u) const
+		{
+			return rows.data() + row[u];
+		}
+
+		static size_t get_row_length(VertexID graph_size)
+		{
+			if constexpr (fixed_row_length > 0)
+			{
+				assert(graph_size <= fixed_row_length * Packed_Bits);
+				return fixed_row_length;
+			}
+			return (graph_size + Packed_Bits - 1) / Packed_Bits;
+		}
+
+		size_t get_row_length() const
+		{
+			if constexpr (fixed_row_length > 0) {return fixed_row_length;}
+			return row_length;
+		}
+
+		static std::vector<Packed> alloc_rows(VertexID graph_size, size_t rows)
+		{
+			return std::vector<Packed>(rows * get_row_length(graph_size), 0);
+		}
+
+		std::vector<Packed> alloc_rows(size_t rows) const
+		{
+			return std::vector<Packed>(rows * row_length, 0);
+		}
+
+		bool verify() const
+		{
+			bool valid = true;
+			size_t count = 0;
+			if(Row::popcount(rows.data(), row_length) != 0)
+			{
+				std::cerr << "[pair set] shared empty row is not empty\n";
+				valid = false;
+			}
+			for(VertexID u = 0; u < n; u++)
+			{
+				if(Row::popcount(get_row(u), row_length) != row_degree[u])
+				{
+					std::cerr << "[pair set] wrong degree for " << +u << "\n";
+					valid = false;
+				}
+				for_neighbours(u, [&](VertexID v) {
+					count++;
+					if(!has_edge(v, u))
+					{
+						std::cerr << "[pair set] " << +u << " -> " << +v << " but not " << +v << " -> " << +u << "\n";
+						valid = false;
+					}
+					return false;
+				});
+			}
+			if(count != 2 * num_edges)
+			{
+				std::cerr << "[pair set] counted " << count / 2 << " pairs, expected " << num_edges << "\n";
+				valid = false;
+			}
+			if(!valid) {abort();}
+			return valid;
+		}
+
+		void clear()
+		{
+			num_edges = 0;
+			for(size_t r = 1; r < row_owner.size(); r++)
+			{
+				VertexID u = row_owner[r];
+				if(row[u] == r * row_length)
+				{
+					row[u] = empty_row;
+					row_degree[u] = 0;
+				}
+			}
+			// shrinking keeps the capacity, rows are zeroed again when they are handed out
+			rows.resize(row_length);
+			row_owner.resize(1);
+			free_rows.clear();
+		}
+
+	private:
+		void insert_half(VertexID u, VertexID v)
+		{
+			if(row[u] == empty_row)
+			{
+				if(free_rows.empty())
+				{
+					row[u] = rows.size();
+					rows.resize(rows.size() + row_length, 0);
+					row_owner.push_back(u);
+				}
+				else
+				{
+					row[u] = free_rows.back();
+					free_rows.pop_back();
+					row_owner[row[u] / row_length] = u;
+				}
+			}
+			rows[row[u] + v / Packed_Bits] |= Packed(1) << (v % Packed_Bits);
+			row_degree[u]++;
+		}
+
+		/* rows are empty again when they are released, so they can be reused without clearing */
+		void erase_half(VertexID u, VertexID v)
+		{
+			rows[row[u] + v / Packed_Bits] &= ~(Packed(1) << (v % Packed_Bits));
+			if(--row_degree[u] == 0)
+			{
+				free_rows.push_back(row[u]);
+				row[u] = empty_row;
+			}
+		}
+	};
+
+	using Pair_Set = Pair_Set_Impl<VertexID>;
+}
+
+#endif
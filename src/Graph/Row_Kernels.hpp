@@ -0,0 +1,183 @@
+#ifndef GRAPH_ROW_KERNELS_HPP
+#define GRAPH_ROW_KERNELS_HPP
+
+#include <stddef.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define ROW_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+#include "../config.hpp"
+
+namespace Graph
+{
+	/** Operations on whole adjacency rows.
+	 * Long rows are processed by AVX2/AVX-512 kernels selected at runtime, short rows and other CPUs use inline scalar loops.
+	 */
+	namespace Row
+	{
+		/* rows with less words are not worth an indirect call.
+		 * If the build already targets AVX2 (-march=native), the compiler vectorizes the inline scalar loops,
+		 * which are as fast as the kernels up to about 32 words, i.e. 2048 vertices.
+		 * Otherwise the scalar loops are plain 64 bit operations and the kernels win from 4 words on.
+		 */
+#ifdef __AVX2__
+		constexpr size_t dispatch_min_words = 32;
+#else
+		constexpr size_t dispatch_min_words = 4;
+#endif
+
+		namespace Kernels
+		{
+			inline size_t popcount_scalar(Packed const *a, size_t words)
+			{
+				size_t count = 0;
+				for(size_t i = 0; i < words; i++) {count += PACKED_POP(a[i]);}
+				return count;
+			}
+
+			inline void or_scalar(Packed *dst, Packed const *a, Packed const *b, size_t words)
+			{
+				for(size_t i = 0; i < words; i++) {dst[i] = a[i] | b[i];}
+			}
+
+			inline void and_scalar(Packed *dst, Packed const *a, Packed const *b, size_t words)
+			{
+				for(size_t i = 0; i < words; i++) {dst[i] = a[i] & b[i];}
+			}
+
+			inline void andnot_scalar(Packed *dst, Packed const *a, Packed const *b, size_t words)
+			{
+				for(size_t i = 0; i < words; i++) {dst[i] = a[i] & ~b[i];}
+			}
+
+#ifdef ROW_KERNELS_X86
+			static_assert(sizeof(Packed) == 8, "SIMD row kernels assume 64 bit Packed");
+
+			/* popcount of 4 words via nibble lookup (Mula et al.) */
+			__attribute__((target("avx2"))) inline size_t popcount_avx2(Packed const *a, size_t words)
+			{
+				__m256i const lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+				__m256i const low_mask = _mm256_set1_epi8(0x0f);
+				__m256i acc = _mm256_setzero_si256();
+				size_t i = 0;
+				for(; i + 4 <= words; i += 4)
+				{
+					__m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(a + i));
+					__m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+					__m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+					acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+				}
+				size_t count = _mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) + _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3);
+				for(; i < words; i++) {count += __builtin_popcountll(a[i]);}
+				return count;
+			}
+
+			__attribute__((target("avx512f,avx512vpopcntdq"))) inline size_t popcount_avx512(Packed const *a, size_t words)
+			{
+				__m512i acc = _mm512_setzero_si512();
+				size_t i = 0;
+				for(; i + 8 <= words; i += 8)
+				{
+					acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(a + i)));
+				}
+				alignas(64) uint64_t lanes[8];
+				_mm512_store_si512(lanes, acc);
+				size_t count = 0;
+				for(uint64_t lane: lanes) {count += lane;}
+				for(; i < words; i++) {count += __builtin_popcountll(a[i]);}
+				return count;
+			}
+
+#define ROW_KERNELS_BINARY(op, target_name, target_isa, vec, width, load, store, combine) \
+			__attribute__((target(target_isa))) inline void op##_##target_name(Packed *dst, Packed const *a, Packed const *b, size_t words) \
+			{ \
+				size_t i = 0; \
+				for(; i + width <= words; i += width) \
+				{ \
+					vec va = load(reinterpret_cast<vec const *>(a + i)); \
+					vec vb = load(reinterpret_cast<vec const *>(b + i)); \
+					store(reinterpret_cast<vec *>(dst + i), combine); \
+				} \
+				op##_scalar(dst + i, a + i, b + i, words - i); \
+			}
+
+			ROW_KERNELS_BINARY(or, avx2, "avx2", __m256i, 4, _mm256_loadu_si256, _mm256_storeu_si256, _mm256_or_si256(va, vb))
+			ROW_KERNELS_BINARY(and, avx2, "avx2", __m256i, 4, _mm256_loadu_si256, _mm256_storeu_si256, _mm256_and_si256(va, vb))
+			ROW_KERNELS_BINARY(andnot, avx2, "avx2", __m256i, 4, _mm256_loadu_si256, _mm256_storeu_si256, _mm256_andnot_si256(vb, va))
+			ROW_KERNELS_BINARY(or, avx512, "avx512f", __m512i, 8, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_or_si512(va, vb))
+			ROW_KERNELS_BINARY(and, avx512, "avx512f", __m512i, 8, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_and_si512(va, vb))
+			ROW_KERNELS_BINARY(andnot, avx512, "avx512f", __m512i, 8, _mm512_loadu_si512, _mm512_storeu_si512, _mm512_and_si512(va, _mm512_xor_si512(vb, _mm512_set1_epi64(-1))))
+#undef ROW_KERNELS_BINARY
+#endif
+
+			struct Table
+			{
+				size_t (*popcount)(Packed const *, size_t);
+				void (*or_rows)(Packed *, Packed const *, Packed const *, size_t);
+				void (*and_rows)(Packed *, Packed const *, Packed const *, size_t);
+				void (*andnot_rows)(Packed *, Packed const *, Packed const *, size_t);
+			};
+
+			inline Table select()
+			{
+				Table table{popcount_scalar, or_scalar, and_scalar, andnot_scalar};
+#ifdef ROW_KERNELS_X86
+				__builtin_cpu_init();
+				if(__builtin_cpu_supports("avx2"))
+				{
+					table = Table{popcount_avx2, or_avx2, and_avx2, andnot_avx2};
+				}
+				if(__builtin_cpu_supports("avx512f"))
+				{
+					table.or_rows = or_avx512;
+					table.and_rows = and_avx512;
+					table.andnot_rows = andnot_avx512;
+				}
+				if(__builtin_cpu_supports("avx512vpopcntdq"))
+				{
+					table.popcount = popcount_avx512;
+				}
+#endif
+				return table;
+			}
+
+			inline Table const &table()
+			{
+				static Table const selected = select();
+				return selected;
+			}
+		}
+
+		/** Number of set bits in a[0..words) */
+		inline size_t popcount(Packed const *a, size_t words)
+		{
+			if(words < dispatch_min_words) {return Kernels::popcount_scalar(a, words);}
+			return Kernels::table().popcount(a, words);
+		}
+
+		/** dst = a | b, dst may alias a or b */
+		inline void or_rows(Packed *dst, Packed const *a, Packed const *b, size_t words)
+		{
+			if(words < dispatch_min_words) {Kernels::or_scalar(dst, a, b, words);}
+			else {Kernels::table().or_rows(dst, a, b, words);}
+		}
+
+		/** dst = a & b, dst may alias a or b */
+		inline void and_rows(Packed *dst, Packed const *a, Packed const *b, size_t words)
+		{
+			if(words < dispatch_min_words) {Kernels::and_scalar(dst, a, b, words);}
+			else {Kernels::table().and_rows(dst, a, b, words);}
+		}
+
+		/** dst = a & ~b, dst may alias a or b */
+		inline void andnot_rows(Packed *dst, Packed const *a, Packed const *b, size_t words)
+		{
+			if(words < dispatch_min_words) {Kernels::andnot_scalar(dst, a, b, words);}
+			else {Kernels::table().andnot_rows(dst, a, b, words);}
+		}
+	}
+}
+
+#endif
@@ -18,25 +18,25 @@ public:
 	static constexpr char const *name = "Value_Matrix";
 
 private:
-	VertexID n;
+	size_t n;
 	std::vector<value_type> matrix;
 
 public:
-	Value_Matrix(VertexID n) : n(n), matrix(n*(n-1)/2)
+	Value_Matrix(size_t n) : n(n), matrix(n * (n - 1) / 2)
 	{}
 
-	VertexID size() const
+	size_t size() const
 	{
 		return n;
 	}
 
-	value_type& at(VertexID u, VertexID v)
+	value_type& at(size_t u, size_t v)
 	{
 		if (u > v) std::swap(u, v);
 		return matrix[v * (v - 1) / 2 + u];
 	}
 
-	const value_type& at(VertexID u, VertexID v) const
+	const value_type& at(size_t u, size_t v) const
 	{
 		if (u > v) std::swap(u, v);
 		return matrix[v * (v - 1) / 2 + u];
@@ -44,9 +44,9 @@ public:
 
 	template<typename F>
 	void forAllNodePairs(F f) {
-		VertexID u = 0, v = 1;
+		size_t u = 0, v = 1;
 		for (size_t i = 0; i < matrix.size(); ++i) {
-			assert(v * static_cast<size_t>(v - 1) / 2 + u == i);
+			assert(v * (v - 1) / 2 + u == i);
 			f(u, v, matrix[i]);
 			++u;
 			if (u == v)
@@ -59,9 +59,9 @@ public:
 
 	template<typename F>
 	void forAllNodePairs(F f) const {
-		VertexID u = 0, v = 1;
+		size_t u = 0, v = 1;
 		for (size_t i = 0; i < matrix.size(); ++i) {
-			assert(v * static_cast<size_t>(v - 1) / 2 + u == i);
+			assert(v * (v - 1) / 2 + u == i);
 			f(u, v, matrix[i]);
 			++u;
 			if (u == v)
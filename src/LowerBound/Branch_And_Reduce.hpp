@@ -0,0 +1,504 @@
+#ifndef LOWER_BOUND_BRANCH_AND_REDUCE_HPP
+#define LOWER_BOUND_BRANCH_AND_REDUCE_HPP
+
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <cassert>
+#include "../config.hpp"
+#include "../Graph/Row_Kernels.hpp"
+
+namespace Lower_Bound
+{
+	/**
+	 * Maximum independent set solver for the conflict graph of forbidden subgraphs, an independent set of it is a packing.
+	 * The graph is first reduced by the degree-0/1/2, domination and twin rules,
+	 * then each component of the remaining kernel is solved by branch-and-bound with a clique cover bound.
+	 * When the deadline passes, the best independent set found so far is returned.
+	 */
+	class Branch_And_Reduce
+	{
+	public:
+		using Vertex = uint32_t;
+		using Clock = std::chrono::steady_clock;
+	private:
+		enum class Status : uint8_t {Alive, Included, Excluded, Folded};
+
+		/* vertices replaced by merged: if merged is in the independent set outer is, otherwise inner is */
+		struct Fold
+		{
+			std::vector<Vertex> inner;
+			std::vector<Vertex> outer;
+			Vertex merged;
+		};
+
+		/* kernel components with more vertices are solved greedily only, their adjacency matrix would be too large */
+		static constexpr size_t max_branching_size = 16384;
+		/* the deadline is checked once per this many reduction checks or search nodes */
+		static constexpr size_t deadline_interval = 64;
+
+		const size_t original_size;
+		/* sorted, may contain vertices that are no longer alive; merged vertices get the largest ids so appending keeps the lists sorted */
+		std::vector<std::vector<Vertex>> adjacency;
+		/* number of alive neighbours of an alive vertex */
+		std::vector<size_t> degree;
+		std::vector<Status> status;
+		std::vector<Fold> folds;
+		/* vertices to check for the degree rules */
+		std::vector<Vertex> queue;
+		std::vector<size_t> marker;
+		size_t marker_round = 0;
+		/* index of a vertex in the component solved by branch_and_bound */
+		std::vector<size_t> position;
+
+		Clock::time_point deadline;
+		size_t steps = 0;
+		bool timed_out = false;
+		bool solved_optimally = true;
+	public:
+		/** adjacency must be symmetric, sorted and without loops */
+		Branch_And_Reduce(std::vector<std::vector<Vertex>> adjacency) : original_size(adjacency.size()), adjacency(std::move(adjacency)), degree(original_size), status(original_size, Status::Alive), marker(original_size, 0)
+		{
+			for (Vertex v = 0; v < original_size; ++v)
+			{
+				degree[v] = this->adjacency[v].size();
+			}
+		}
+
+		/**
+		 * Returns an independent set, which is only searched to be larger than at_least.
+		 * If optimal() afterwards, no independent set is larger than both.
+		 */
+		std::vector<Vertex> solve(Clock::time_point until, size_t at_least = 0)
+		{
+			deadline = until;
+
+			reduce();
+			solve_kernel(at_least);
+
+			for (size_t i = folds.size(); i-- > 0;)
+			{
+				const Fold& fold = folds[i];
+				for (Vertex x : status[fold.merged] == Status::Included ? fold.outer : fold.inner)
+				{
+					status[x] = Status::Included;
+				}
+			}
+
+			std::vector<Vertex> independent_set;
+			for (Vertex v = 0; v < original_size; ++v)
+			{
+				if (status[v] == Status::Included) {independent_set.push_back(v);}
+			}
+
+			return independent_set;
+		}
+
+		bool optimal() const
+		{
+			return solved_optimally;
+		}
+
+	private:
+		bool out_of_time()
+		{
+			if (!timed_out && ++steps % deadline_interval == 0 && Clock::now() >= deadline)
+			{
+				timed_out = true;
+				solved_optimally = false;
+			}
+
+			return timed_out;
+		}
+
+		bool alive(Vertex v) const
+		{
+			return status[v] == Status::Alive;
+		}
+
+		/** The alive neighbours of v, drops the others from its list */
+		std::vector<Vertex>& neighbors(Vertex v)
+		{
+			std::vector<Vertex>& n = adjacency[v];
+			if (n.size() != degree[v])
+			{
+				n.erase(std::remove_if(n.begin(), n.end(), [&](Vertex u) {return !alive(u);}), n.end());
+			}
+
+			assert(n.size() == degree[v]);
+			return n;
+		}
+
+		bool adjacent(Vertex u, Vertex v) const
+		{
+			const std::vector<Vertex>& n = adjacency[u].size() < adjacency[v].size() ? adjacency[u] : adjacency[v];
+			return std::binary_search(n.begin(), n.end(), &n == &adjacency[u] ? v : u);
+		}
+
+		void kill(Vertex v, Status reason)
+		{
+			assert(alive(v));
+			status[v] = reason;
+			for (Vertex x : neighbors(v))
+			{
+				--degree[x];
+				queue.push_back(x);
+			}
+		}
+
+		void include(Vertex v)
+		{
+			kill(v, Status::Included);
+			for (Vertex u : adjacency[v])
+			{
+				if (alive(u)) {kill(u, Status::Excluded);}
+			}
+		}
+
+		/** Replaces inner and outer by a vertex adjacent to the alive neighbours of outer, the outer vertices must be pairwise non-adjacent */
+		void fold(std::vector<Vertex> inner, std::vector<Vertex> outer)
+		{
+			for (Vertex x : inner) {kill(x, Status::Folded);}
+			for (Vertex x : outer) {kill(x, Status::Folded);}
+
+			std::vector<Vertex> merged_neighbors;
+			for (Vertex x : outer)
+			{
+				for (Vertex y : adjacency[x])
+				{
+					if (alive(y)) {merged_neighbors.push_back(y);}
+				}
+			}
+
+			std::sort(merged_neighbors.begin(), merged_neighbors.end());
+			merged_neighbors.erase(std::unique(merged_neighbors.begin(), merged_neighbors.end()), merged_neighbors.end());
+
+			const Vertex merged = adjacency.size();
+			for (Vertex y : merged_neighbors)
+			{
+				adjacency[y].push_back(merged);
+				++degree[y];
+			}
+
+			degree.push_back(merged_neighbors.size());
+			adjacency.push_back(std::move(merged_neighbors));
+			status.push_back(Status::Alive);
+			marker.push_back(0);
+			queue.push_back(merged);
+			folds.push_back(Fold{std::move(inner), std::move(outer), merged});
+		}
+
+		/** Degree 0 and 1: take the vertex; degree 2: take it if its neighbours are adjacent, fold it with them otherwise */
+		void reduce_low_degree(Vertex v)
+		{
+			const std::vector<Vertex>& n = neighbors(v);
+			if (n.size() <= 1 || adjacent(n[0], n[1]))
+			{
+				include(v);
+			}
+			else
+			{
+				fold({v}, {n[0], n[1]});
+			}
+		}
+
+		/** Removes the neighbours u of each vertex v with N[v] a subset of N[u], some maximum independent set avoids them */
+		bool remove_dominated()
+		{
+			bool changed = false;
+			for (Vertex v = 0; v < adjacency.size() && !out_of_time(); ++v)
+			{
+				if (!alive(v)) continue;
+
+				++marker_round;
+				marker[v] = marker_round;
+				for (Vertex x : neighbors(v)) {marker[x] = marker_round;}
+
+				for (Vertex u : adjacency[v])
+				{
+					if (!alive(u) || degree[u] < degree[v]) continue;
+
+					// all of N[v] but u itself has to be in N(u), so at most degree[u] - degree[v] neighbours of u may be unmarked
+					size_t unmarked = 0;
+					const size_t allowed = degree[u] - degree[v];
+					for (Vertex x : neighbors(u))
+					{
+						if (marker[x] != marker_round && ++unmarked > allowed) break;
+					}
+
+					if (unmarked <= allowed)
+					{
+						kill(u, Status::Excluded);
+						changed = true;
+					}
+				}
+			}
+
+			return changed;
+		}
+
+		/** Handles pairs of degree-3 vertices with equal neighbourhoods: takes both if the neighbourhood has an edge, folds all five otherwise */
+		bool fold_twins()
+		{
+			bool changed = false;
+			for (Vertex v = 0; v < adjacency.size() && !out_of_time(); ++v)
+			{
+				if (!alive(v) || degree[v] != 3) continue;
+
+				const std::vector<Vertex> n = neighbors(v);
+				Vertex twin = v;
+				for (Vertex u : adjacency[n[0]])
+				{
+					if (u != v && alive(u) && degree[u] == 3 && neighbors(u) == n)
+					{
+						twin = u;
+						break;
+					}
+				}
+
+				if (twin == v) continue;
+
+				if (adjacent(n[0], n[1]) || adjacent(n[0], n[2]) || adjacent(n[1], n[2]))
+				{
+					include(v);
+					include(twin);
+				}
+				else
+				{
+					fold({v, twin}, {n[0], n[1], n[2]});
+				}
+
+				changed = true;
+			}
+
+			return changed;
+		}
+
+		void reduce()
+		{
+			queue.resize(original_size);
+			std::iota(queue.begin(), queue.end(), 0);
+
+			do
+			{
+				while (!queue.empty() && !out_of_time())
+				{
+					const Vertex v = queue.back();
+					queue.pop_back();
+					if (alive(v) && degree[v] <= 2) {reduce_low_degree(v);}
+				}
+			}
+			while (!timed_out && (remove_dominated() || fold_twins()));
+
+			queue.clear();
+		}
+
+		void solve_kernel(size_t at_least)
+		{
+			// the independent set gains one vertex per included vertex and per inner vertex of a fold
+			size_t found = std::count(status.begin(), status.end(), Status::Included);
+			for (const Fold& fold : folds) {found += fold.inner.size();}
+
+			std::vector<std::vector<Vertex>> components;
+			std::vector<bool> visited(adjacency.size(), false);
+			for (Vertex s = 0; s < adjacency.size(); ++s)
+			{
+				if (!alive(s) || visited[s]) continue;
+
+				std::vector<Vertex> component(1, s);
+				visited[s] = true;
+				for (size_t i = 0; i < component.size(); ++i)
+				{
+					for (Vertex x : neighbors(component[i]))
+					{
+						if (!visited[x])
+						{
+							visited[x] = true;
+							component.push_back(x);
+						}
+					}
+				}
+
+				components.push_back(std::move(component));
+			}
+
+			std::sort(components.begin(), components.end(), [](const auto& a, const auto& b) {return a.size() < b.size();});
+
+			// a clique cover of each component bounds its independent sets, if they cannot add up to more than at_least there is nothing to search
+			std::vector<size_t> cover(components.size());
+			size_t upper = found;
+			for (size_t i = 0; i < components.size(); ++i)
+			{
+				cover[i] = clique_cover_size(components[i]);
+				upper += cover[i];
+			}
+
+			if (upper <= at_least) return;
+
+			// each component has to beat at_least minus what the components before it found and the covers of those after it allow, the largest one is solved last
+			size_t rest = upper - found;
+			for (size_t i = 0; i < components.size(); ++i)
+			{
+				rest -= cover[i];
+				const size_t to_beat = found + rest < at_least ? at_least - found - rest : 0;
+				found += solve_component(components[i], to_beat);
+			}
+		}
+
+		/** Size of a greedy clique cover of component: each vertex joins the first clique all of whose members are its neighbours, in time linear in the edges */
+		size_t clique_cover_size(const std::vector<Vertex>& component)
+		{
+			/* size of each clique, the clique of each covered vertex of component by position */
+			std::vector<size_t> clique_sizes, clique_of(component.size());
+			/* neighbours of the current vertex in each clique, only the cliques in touched are non-zero */
+			std::vector<size_t> in_clique, touched;
+
+			position.resize(adjacency.size());
+			for (size_t i = 0; i < component.size(); ++i) {position[component[i]] = i;}
+
+			++marker_round;
+			for (size_t i = 0; i < component.size(); ++i)
+			{
+				touched.clear();
+				for (Vertex x : neighbors(component[i]))
+				{
+					if (marker[x] != marker_round) continue;
+					const size_t c = clique_of[position[x]];
+					if (in_clique[c]++ == 0) {touched.push_back(c);}
+				}
+
+				size_t joined = clique_sizes.size();
+				for (size_t c : touched)
+				{
+					if (in_clique[c] == clique_sizes[c]) {joined = std::min(joined, c);}
+					in_clique[c] = 0;
+				}
+
+				if (joined == clique_sizes.size())
+				{
+					clique_sizes.push_back(0);
+					in_clique.push_back(0);
+				}
+
+				clique_of[i] = joined;
+				++clique_sizes[joined];
+				marker[component[i]] = marker_round;
+			}
+
+			return clique_sizes.size();
+		}
+
+		/** Includes an independent set of component, searched to be larger than to_beat, and returns its size */
+		size_t solve_component(std::vector<Vertex>& component, size_t to_beat)
+		{
+			std::sort(component.begin(), component.end(), [&](Vertex x, Vertex y) {return degree[x] < degree[y];});
+
+			// greedy by increasing degree as the incumbent
+			std::vector<Vertex> best;
+			++marker_round;
+			for (size_t i = 0; i < component.size(); ++i)
+			{
+				if (marker[component[i]] == marker_round) continue;
+
+				best.push_back(i);
+				for (Vertex x : neighbors(component[i])) {marker[x] = marker_round;}
+			}
+
+			if (component.size() > max_branching_size)
+			{
+				solved_optimally = false;
+			}
+			else if (!timed_out)
+			{
+				branch_and_bound(component, best, std::max(to_beat, best.size()));
+			}
+
+			for (Vertex i : best)
+			{
+				status[component[i]] = Status::Included;
+			}
+
+			return best.size();
+		}
+
+		/** Replaces best, given as positions in component, by an independent set larger than to_beat if there is one */
+		void branch_and_bound(const std::vector<Vertex>& component, std::vector<Vertex>& best, size_t to_beat)
+		{
+			const size_t words = (component.size() + Packed_Bits - 1) / Packed_Bits;
+
+			position.resize(adjacency.size());
+			for (size_t i = 0; i < component.size(); ++i) {position[component[i]] = i;}
+
+			std::vector<Packed> matrix(component.size() * words, 0);
+			for (size_t i = 0; i < component.size(); ++i)
+			{
+				for (Vertex x : neighbors(component[i]))
+				{
+					matrix[i * words + position[x] / Packed_Bits] |= Packed(1) << (position[x] % Packed_Bits);
+				}
+			}
+
+			std::vector<Packed> candidates(words, 0);
+			for (size_t i = 0; i < component.size(); ++i) {candidates[i / Packed_Bits] |= Packed(1) << (i % Packed_Bits);}
+
+			std::vector<Vertex> current;
+			expand(matrix, words, candidates, current, best, to_beat);
+		}
+
+		/** Extends current by independent vertices of candidates, orders them by a greedy clique cover that bounds the rest */
+		void expand(const std::vector<Packed>& matrix, size_t words, std::vector<Packed>& candidates, std::vector<Vertex>& current, std::vector<Vertex>& best, size_t& to_beat)
+		{
+			if (out_of_time()) return;
+
+			auto any = [](const std::vector<Packed>& bits) {return std::any_of(bits.begin(), bits.end(), [](Packed p) {return p != 0;});};
+			auto first = [](const std::vector<Packed>& bits) {size_t w = 0; while (bits[w] == 0) {++w;} return w * Packed_Bits + PACKED_CTZ(bits[w]);};
+
+			std::vector<Vertex> order;
+			std::vector<size_t> cover_size;
+			std::vector<Packed> uncovered = candidates, clique(words);
+			size_t cliques = 0;
+			while (any(uncovered))
+			{
+				++cliques;
+				clique = uncovered;
+				while (any(clique))
+				{
+					const Vertex v = first(clique);
+					uncovered[v / Packed_Bits] &= ~(Packed(1) << (v % Packed_Bits));
+					::Graph::Row::and_rows(clique.data(), clique.data(), matrix.data() + v * words, words);
+
+					order.push_back(v);
+					cover_size.push_back(cliques);
+				}
+			}
+
+			std::vector<Packed> next(words);
+			for (size_t i = order.size(); i-- > 0;)
+			{
+				// the candidates left are order[0..i], covered by cover_size[i] cliques
+				if (current.size() + cover_size[i] <= to_beat || timed_out) return;
+
+				const Vertex v = order[i];
+				candidates[v / Packed_Bits] &= ~(Packed(1) << (v % Packed_Bits));
+				::Graph::Row::andnot_rows(next.data(), candidates.data(), matrix.data() + v * words, words);
+
+				current.push_back(v);
+				if (any(next))
+				{
+					expand(matrix, words, next, current, best, to_beat);
+				}
+				else if (current.size() > to_beat)
+				{
+					best = current;
+					to_beat = best.size();
+				}
+				current.pop_back();
+			}
+		}
+	};
+}
+
+#endif
@@ -4,25 +4,47 @@
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <limits>
+#include <numeric>
 #include "../config.hpp"
+#include "../Options.hpp"
 #include "../Finder/Finder.hpp"
+#include "../Graph/PairMap.hpp"
 #include <iostream>
 #include <sstream>
 #include <cassert>
 
 namespace Lower_Bound
 {
+	/**
+	 * A set of forbidden subgraphs that share no editable vertex pair.
+	 * When constructed with the graph size, the pairs used by the subgraphs are indexed:
+	 * used_pairs() has them marked and find() returns the subgraph using a pair, both maintained by the methods taking the graph.
+	 * Otherwise only add(subgraph) and add(begin, end) may be used, and the index stays empty.
+	 * With the index, remove_for_edit(), add_if_disjoint() and update() keep the bound maximal while the search edits and marks pairs.
+	 */
 	template<typename Mode, typename Restriction, typename Conversion, typename Graph, typename Graph_Edits, size_t length>
 	class Lower_Bound
 	{
 	public:
+		using VertexID = typename Graph::VertexID;
 		using subgraph_t = std::array<VertexID, length>;
+		static constexpr size_t none = std::numeric_limits<size_t>::max();
 	private:
 		std::vector<subgraph_t> bound;
+		Graph_Edits used;
+		/* the index in bound of the subgraph using each pair of used */
+		::Graph::Pair_Map owners;
+		/* removed by remove_for_edit(), its pairs are refilled by update() */
+		bool has_removed_subgraph = false;
+		subgraph_t removed_subgraph;
 	public:
+		Lower_Bound(VertexID graph_size = 0) : used(graph_size) {;}
+
 		template <typename iterator_t>
 		void add(const iterator_t& begin, const iterator_t& end)
 		{
+			assert(used.size() == 0);
 			bound.emplace_back();
 			iterator_t it = begin;
 			for (size_t i = 0; i < length; ++i) {
@@ -37,41 +59,169 @@ namespace Lower_Bound
 
 		void add(const subgraph_t& sg)
 		{
+			assert(used.size() == 0);
+			bound.emplace_back(sg);
+		}
+
+		/** Adds sg and indexes its editable pairs, which must not be used yet */
+		void add(const Graph& graph, const Graph_Edits& edited, const subgraph_t& sg)
+		{
+			assert(used.size() == graph.size());
 			bound.emplace_back(sg);
+			index_pairs(graph, edited, bound.size() - 1);
+		}
+
+		/** Replaces bound[i] by sg */
+		void replace(size_t i, const Graph& graph, const Graph_Edits& edited, const subgraph_t& sg)
+		{
+			assert(used.size() == graph.size());
+			unindex_pairs(i);
+			bound[i] = sg;
+			index_pairs(graph, edited, i);
+		}
+
+		/** Removes bound[i], the last subgraph takes its place */
+		subgraph_t remove_at(size_t i)
+		{
+			subgraph_t removed = bound[i];
+			unindex_pairs(i);
+			if (i + 1 != bound.size())
+			{
+				bound[i] = bound.back();
+				for_all_pairs(bound[i], [&](VertexID x, VertexID y)
+				{
+					if (used.has_edge(x, y) && owners.find(x, y) == bound.size() - 1) {owners.set(x, y, i);}
+				});
+			}
+			bound.pop_back();
+			return removed;
 		}
 
 		/**
-		 * Removes any forbidden subgraphs that contain the given vertex pair (u, v).
+		 * Removes the forbidden subgraph that uses the given vertex pair (u, v), if any.
 		 */
-		void remove(const Graph& graph, const Graph_Edits& edited, VertexID u, VertexID v)
+		void remove(const Graph&, const Graph_Edits& edited, VertexID u, VertexID v)
 		{
 			if (edited.has_edge(u, v))
 			{
 				abort();
 			}
-			auto new_end = std::remove_if(bound.begin(),
-				       bound.end(),
-				       [&](const subgraph_t& subgraph) -> bool
-				       {
-					       return ::Finder::for_all_edges_unordered<Mode, Restriction, Conversion, Graph, Graph_Edits>(graph,
-											edited,
-											subgraph.begin(),
-											subgraph.end(),
-											[&](auto x, auto y)
-											{
-												return (u == *x && v == *y) || (u == *y && v == *x);
-											}
-											);
-
-				       }
-				       );
-
-			bound.erase(new_end, bound.end());
+
+			size_t i = find(u, v);
+			if (i != none) {remove_at(i);}
+		}
+
+		/** The pair (u, v) has been marked as edited, the subgraph using it keeps its other pairs */
+		void release(VertexID u, VertexID v)
+		{
+			if (used.size() == 0 || !used.has_edge(u, v)) return;
+			owners.erase(u, v);
+			used.clear_edge(u, v);
+		}
+
+		/** Index of the subgraph using the pair (u, v), none if no subgraph uses it */
+		size_t find(VertexID u, VertexID v) const
+		{
+			if (used.size() == 0 || !used.has_edge(u, v)) return none;
+			assert(owners.find(u, v) != none);
+			return owners.find(u, v);
+		}
+
+		const Graph_Edits& used_pairs() const
+		{
+			return used;
+		}
+
+		/**
+		 * Does an editable pair of sg belong to the bound?
+		 * The searches masked by used_pairs() list exactly the subgraphs for which this is false, as they never mask the pair closing a subgraph, which Skip does not edit.
+		 */
+		bool touches(const Graph& graph, const Graph_Edits& edited, const subgraph_t& sg) const
+		{
+			return ::Finder::for_all_edges_unordered<Mode, Restriction, Conversion, Graph, Graph_Edits>(graph, edited, sg.begin(), sg.end(), [&](auto uit, auto vit)
+			{
+				return used.has_edge(*uit, *vit);
+			});
+		}
+
+		/** Adds sg if it shares no editable pair with the bound, like the subgraphs the searches masked by used_pairs() list; returns whether it was added */
+		bool add_if_disjoint(const Graph& graph, const Graph_Edits& edited, const subgraph_t& sg)
+		{
+			if (touches(graph, edited, sg)) return false;
+			add(graph, edited, sg);
+			return true;
+		}
+
+		/** Before the pair (u, v) is marked and edited: removes the subgraph using it, update() refills its other pairs after the edit */
+		void remove_for_edit(VertexID u, VertexID v)
+		{
+			assert(!has_removed_subgraph);
+
+			const size_t i = find(u, v);
+			if (i != none)
+			{
+				removed_subgraph = remove_at(i);
+				has_removed_subgraph = true;
+			}
+		}
+
+		/**
+		 * After an edit or a mark: adds the subgraphs that find_new(add_new) passes to add_new if they are disjoint from the bound,
+		 * then refills the pairs of the subgraph removed by remove_for_edit() by searches masked by used_pairs().
+		 */
+		template <typename finder_t, typename F>
+		void update(const Graph& graph, const Graph_Edits& edited, finder_t& finder, F find_new)
+		{
+			auto add_new = [&](const subgraph_t& sg)
+			{
+				add_if_disjoint(graph, edited, sg);
+				return false;
+			};
+
+			find_new(add_new);
+			if (has_removed_subgraph)
+			{
+				::Finder::for_all_edges_unordered<Mode, Restriction, Conversion, Graph, Graph_Edits>(graph, edited, removed_subgraph.begin(), removed_subgraph.end(), [&](auto uit, auto vit)
+				{
+					if (!used.has_edge(*uit, *vit))
+					{
+						finder.find_near(graph, *uit, *vit, add_new, used);
+					}
+
+					return false;
+				});
+
+				has_removed_subgraph = false;
+			}
+
+			assert_maximal(graph, edited, finder);
+		}
+
+		template <typename URBG>
+		void shuffle(URBG& gen)
+		{
+			std::vector<size_t> order(bound.size());
+			std::iota(order.begin(), order.end(), 0);
+			std::shuffle(order.begin(), order.end(), gen);
+
+			std::vector<subgraph_t> shuffled(bound.size());
+			std::vector<size_t> position(bound.size());
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				shuffled[i] = bound[order[i]];
+				position[order[i]] = i;
+			}
+			bound = std::move(shuffled);
+
+			owners.renumber([&](size_t i) {return position[i];});
 		}
 
 		void clear()
 		{
 			bound.clear();
+			if (used.size() > 0) {used.clear();}
+			owners.clear();
+			has_removed_subgraph = false;
 		}
 
 
@@ -80,8 +230,10 @@ namespace Lower_Bound
 			return bound;
 		}
 
+		/** Modifying the subgraphs through this bypasses the pair index */
 		std::vector<subgraph_t>& get_bound()
 		{
+			assert(used.size() == 0);
 			return bound;
 		}
 
@@ -127,6 +279,21 @@ namespace Lower_Bound
 					return false;
 				});
 			}
+
+			// Unmarking a pair with the Undo restriction makes it editable again without notice
+			if (used.size() > 0 && !std::is_same<Restriction, Options::Restrictions::Undo>::value)
+			{
+				assert(owners.size() == used.count_edges());
+				for (size_t i = 0; i < bound.size(); ++i)
+				{
+					Finder::for_all_edges_unordered<Mode, Restriction, Conversion, Graph, Graph_Edits>(graph, edited, bound[i].begin(), bound[i].end(), [&](auto uit, auto vit)
+					{
+						assert(find(*uit, *vit) == i);
+						return false;
+					});
+				}
+				assert(in_bound.count_edges() == used.count_edges());
+			}
 			#endif
 		}
 
@@ -199,6 +366,44 @@ namespace Lower_Bound
 			}
 			return ss.str();
 		}
+
+	private:
+		template <typename F>
+		static void for_all_pairs(const subgraph_t& sg, F callback)
+		{
+			for (size_t j = 1; j < length; ++j)
+			{
+				for (size_t i = 0; i < j; ++i)
+				{
+					callback(sg[i], sg[j]);
+				}
+			}
+		}
+
+		void index_pairs(const Graph& graph, const Graph_Edits& edited, size_t i)
+		{
+			::Finder::for_all_edges_unordered<Mode, Restriction, Conversion, Graph, Graph_Edits>(graph, edited, bound[i].begin(), bound[i].end(), [&](auto uit, auto vit)
+			{
+				assert(!used.has_edge(*uit, *vit));
+				used.set_edge(*uit, *vit);
+				owners.set(*uit, *vit, i);
+				return false;
+			});
+		}
+
+		/* all pairs of the subgraph are checked as the editable pairs may have changed since it was added */
+		void unindex_pairs(size_t i)
+		{
+			if (used.size() == 0) return;
+			for_all_pairs(bound[i], [&](VertexID x, VertexID y)
+			{
+				if (used.has_edge(x, y) && owners.find(x, y) == i)
+				{
+					owners.erase(x, y);
+					used.clear_edge(x, y);
+				}
+			});
+		}
 	};
 }
 
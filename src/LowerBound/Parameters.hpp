@@ -0,0 +1,89 @@
+#ifndef LOWER_BOUND_PARAMETERS_HPP
+#define LOWER_BOUND_PARAMETERS_HPP
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../config.hpp"
+
+namespace Lower_Bound
+{
+	/**
+	 * Tuning parameters of the lower bound consumers, set by -b name=value on the command line.
+	 * Consumers tagged with Options::Tag::Parameters receive them through set_parameters() after construction.
+	 */
+	struct Parameters
+	{
+		/* ARW: perturbation rounds of the iterated local search by k minus the bound size, more subgraphs would prune the search */
+		std::vector<size_t> perturbation_rounds_per_gap = {4, 1};
+		/* ARW: perturbation rounds for the bound of the root, where k is not known yet */
+		size_t root_perturbation_rounds = 64;
+		/* ARW: number of rounds the pairs of a forced subgraph stay tabu */
+		size_t tabu_tenure = 4;
+		/* ARW: (2,3)-swaps consider at most this many subgraphs around the two replaced ones, conflicts between them are stored in one Packed */
+		size_t max_swap_candidates = 48;
+		/* MIS: seconds for the independent set search at the root, at most a tenth of -t and split among the components by their size with -S */
+		double mis_time = 10;
+
+		/** Sets the parameter name to value, a comma separated list for perturbation_rounds_per_gap. Returns false if there is no such parameter or value is invalid */
+		bool set(std::string const &name, std::string const &value)
+		{
+			try
+			{
+				if (name == "perturbation_rounds_per_gap")
+				{
+					std::vector<size_t> rounds;
+					for (size_t begin = 0; begin <= value.size();)
+					{
+						size_t end = value.find(',', begin);
+						if (end == std::string::npos) {end = value.size();}
+						rounds.push_back(parse(value.substr(begin, end - begin)));
+						begin = end + 1;
+					}
+					perturbation_rounds_per_gap = rounds;
+				}
+				else if (name == "root_perturbation_rounds") {root_perturbation_rounds = parse(value);}
+				else if (name == "tabu_tenure") {tabu_tenure = parse(value);}
+				else if (name == "max_swap_candidates")
+				{
+					max_swap_candidates = parse(value);
+					if (max_swap_candidates >= Packed_Bits) {return false;}
+				}
+				else if (name == "mis_time")
+				{
+					size_t end;
+					mis_time = std::stod(value, &end);
+					if (end != value.size() || !(mis_time >= 0)) {return false;}
+				}
+				else {return false;}
+			}
+			catch (std::logic_error const &)
+			{
+				return false;
+			}
+			return true;
+		}
+
+		/** Describes the parameters and their defaults for the usage message */
+		static char const *usage()
+		{
+			return
+				"    perturbation_rounds_per_gap=4,1: ARW local search rounds when the bound is k, k-1, ... below k\n"
+				"    root_perturbation_rounds=64: ARW local search rounds at the root\n"
+				"    tabu_tenure=4: ARW rounds a forced subgraph stays in the bound\n"
+				"    max_swap_candidates=48: ARW subgraphs considered by a (2,3)-swap, less than the bits of a Packed\n"
+				"    mis_time=10: MIS seconds for the independent set search at the root, at most a tenth of -t, shared by the components with -S\n";
+		}
+
+	private:
+		static size_t parse(std::string const &value)
+		{
+			size_t end;
+			const size_t result = std::stoull(value, &end);
+			if (end != value.size()) {throw std::invalid_argument(value);}
+			return result;
+		}
+	};
+}
+
+#endif
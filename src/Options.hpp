@@ -49,6 +49,10 @@ namespace Options
 		struct Selector {};
 		/** The consumer calculates a lower bound on the number of edits required */
 		struct Lower_Bound {};
+		/** The lower bound consumer computes the bound of the root by a separate search that may use several threads */
+		struct Root_Bound {};
+		/** The consumer takes the Lower_Bound::Parameters given on the command line by set_parameters() */
+		struct Parameters {};
 		/** The consumers result function should be called (for side effects) */
 		struct Result {};
 	}
@@ -3,6 +3,7 @@
 #include <vector>
 #include "config.hpp"
 
+template<typename VertexID>
 class ProblemSet
 {
 public:
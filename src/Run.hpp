@@ -7,12 +7,16 @@
 #include <vector>
 
 #include "config.hpp"
+#include "LowerBound/Parameters.hpp"
 
 struct CMDOptions {
 	// search space
 	size_t k_min = 0;
 	size_t k_max = 0;
 	bool all_solutions = false;
+	bool split_components = false;
+	// tuning of the lower bounds
+	Lower_Bound::Parameters bound;
 	// time constraints
 	size_t time_max = 0;
 	size_t time_max_hard = 0;
@@ -30,6 +34,7 @@ struct CMDOptions {
 	// graphs
 	std::vector<std::string> filenames;
 	bool edgelist = false;
+	bool graph_cache = true;
 	size_t permutation = 0;
 	// used to show current experiment in child's cmdline
 	int argc = 0;
@@ -11,15 +11,19 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <stdexcept>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "config.hpp"
@@ -185,15 +189,15 @@ public:
 	{
 		using E = _E<F, G, GE, M, R, C, Con<F, G, GE, M, R, C, F::length>...>;
 
-		G input_graph = options.edgelist ? Graph::readEdgeList<G>(filename) : Graph::readMetis<G>(filename);
+		G input_graph = Graph::readGraph<G>(filename, options.edgelist, options.graph_cache);
 		if (!options.no_write)
 		{
 			Graph::writeDot(filename + ".gv", input_graph);
 		}
 
 		// permute node ids
-		const std::vector<VertexID> permutation = Graph::generate_permutation(input_graph, options.permutation);
-		const std::vector<VertexID> reverse_permutation = Graph::invert_permutation(permutation);
+		const std::vector<typename G::VertexID> permutation = Graph::generate_permutation(input_graph, options.permutation);
+		const std::vector<typename G::VertexID> reverse_permutation = Graph::invert_permutation(permutation);
 		const G g_orig = Graph::apply_permutation(input_graph, permutation);
 
 		// warmup
@@ -214,12 +218,19 @@ public:
 		// Reset time limit
 		std::cout << " " << std::flush;
 
+		if(options.split_components)
+		{
+			run_components(options, filename, input_graph, g_orig, reverse_permutation);
+			return;
+		}
+
 		std::chrono::steady_clock::time_point tinit_1, tinit_2;
 		tinit_1 = std::chrono::steady_clock::now();
 
 		G graph = g_orig;
 		F finder(graph.size());
 		std::tuple<Con<F, G, GE, M, R, C, F::length>...> consumer{Con<F, G, GE, M, R, C, F::length>(graph.size())...};
+		set_parameters(consumer, bound_parameters(options, 1));
 		std::tuple<Con<F, G, GE, M, R, C, F::length> &...> consumer_ref = Util::MakeTupleRef(consumer);
 		E editor(finder, graph, consumer_ref, options.threads);
 
@@ -282,22 +293,7 @@ public:
 					json << ",\"total_time\":" << total_time;
 					json << ",\"solutions\":" << writecount;
 #ifdef STATS
-					json << ",\"counters\":{";
-					auto const stats = editor.stats();
-					bool first_stat = true;
-					for(auto stat : stats)
-					{
-						json << (first_stat? "" : ",") << "\"" << stat.first << "\":[";
-						first_stat = false;
-						bool first_value = true;
-						for(auto value : stat.second)
-						{
-							json << (first_value? "" : ",") << +value;
-							first_value = false;
-						}
-						json << ']';
-					}
-					json << '}';
+					write_stats_json(json, editor.stats());
 #endif
 					json << "}},\n";
 					std::cout << json.str() << std::flush;
@@ -308,47 +304,8 @@ public:
 					auto const &stats = editor.stats();
 					if(!stats.empty())
 					{
-						// print stats table with aligned columns
 						std::cout << '\n' << filename << " (permutation: " << options.permutation << "): (exact) " << name() << ", " << +options.threads << " threads, k = " << +k << '\n';
-						std::map<std::string, std::ostringstream> output;
-						{
-							// header cloumn: find longest name
-							size_t l = std::max_element(stats.begin(), stats.end(), [](auto const &a, auto const &b)
-							{
-								return a.first.length() < b.first.length();
-							})->first.length();
-							for(auto const &stat: stats)
-							{
-								output[stat.first] << std::setw(l) << stat.first << ':';
-							}
-							output["k"] << std::setw(l) << "k" << ':';
-						}
-						for(size_t j = 0; j < stats.begin()->second.size(); j++)
-						{
-							// data columns: find largest number
-							size_t m = std::max(j, std::max_element(stats.begin(), stats.end(), [&j](auto const &a, auto const &b)
-							{
-								return a.second[j] < b.second[j];
-							})->second[j]);
-							// figure out charakters needed to print it [ ceil(log_10(m)) ]
-							size_t l = 0;
-							do
-							{
-								m /= 10;
-								l++;
-							}
-							while(m > 0);
-							for(auto const &stat: stats)
-							{
-								output[stat.first] << " " << std::setw(l) << +stat.second[j];
-							}
-							output["k"] << " " << std::setw(l) << +j;
-						}
-						std::cout << output["k"].str() << '\n';
-						for(auto const &stat: stats)
-						{
-							std::cout << output[stat.first].str() << ", total: " << +std::accumulate(stat.second.begin(), stat.second.end(), 0) << '\n';
-						}
+						write_stats_table(std::cout, stats);
 					}
 #endif
 					std::cout << filename << " (permutation: " << options.permutation << "): (exact) " << name() << ", " << +options.threads << " threads, k = " << +k << ": " << (solved ? "yes" : "no") << " [" << time_passed_print << "s + initialization " << time_initialization << "s]\n";
@@ -365,6 +322,284 @@ public:
 		}
 	}
 
+	/** Forbidden subgraphs are connected, so every connected component can be solved on its own; k of the whole graph is the sum of the components' k */
+	static void run_components(CMDOptions const &options, std::string const &filename, G const &input_graph, G const &g_orig, std::vector<typename G::VertexID> const &reverse_permutation)
+	{
+		using E = _E<F, G, GE, M, R, C, Con<F, G, GE, M, R, C, F::length>...>;
+		using VertexID = typename G::VertexID;
+
+		struct Component
+		{
+			std::vector<VertexID> vertices;
+			size_t k = 0;
+			bool solved = false;
+			std::unique_ptr<G> graph;
+			std::unique_ptr<GE> edited;
+		};
+
+		std::chrono::steady_clock::time_point t1, t2;
+		t1 = std::chrono::steady_clock::now();
+
+		// components with less than F::length vertices can't contain a forbidden subgraph
+		std::vector<Component> components;
+		for(auto &vertices: Graph::connected_components(g_orig))
+		{
+			if(vertices.size() < F::length) {continue;}
+			components.emplace_back();
+			components.back().vertices = std::move(vertices);
+		}
+		// start with the largest components to keep the threads busy at the end
+		std::sort(components.begin(), components.end(), [](Component const &a, Component const &b) {return a.vertices.size() > b.vertices.size();});
+
+		t2 = std::chrono::steady_clock::now();
+		double time_initialization = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+
+		size_t component_vertices = 0;
+		for(auto const &component: components) {component_vertices += component.vertices.size();}
+
+		size_t const workers = std::max<size_t>(1, std::min(options.threads, components.size()));
+		size_t const editor_threads = std::max<size_t>(1, options.threads / workers);
+		std::atomic<size_t> next_component(0);
+		std::atomic<bool> stop(false);
+		// initialization and editing times and the counters are summed over all components
+		std::mutex totals_mutex;
+		double time_editing = 0;
+#ifdef STATS
+		std::map<std::string, std::vector<size_t>> stats;
+#endif
+
+		auto solve = [&]()
+		{
+			for(size_t i = next_component++; i < components.size() && !stop; i = next_component++)
+			{
+				Component &component = components[i];
+				std::chrono::steady_clock::time_point tinit_1 = std::chrono::steady_clock::now();
+				G const g_component = Graph::induced_subgraph(g_orig, component.vertices);
+
+				G graph = g_component;
+				F finder(graph.size());
+				std::tuple<Con<F, G, GE, M, R, C, F::length>...> consumer{Con<F, G, GE, M, R, C, F::length>(graph.size())...};
+				set_parameters(consumer, bound_parameters(options, static_cast<double>(component.vertices.size()) / component_vertices));
+				std::tuple<Con<F, G, GE, M, R, C, F::length> &...> consumer_ref = Util::MakeTupleRef(consumer);
+				E editor(finder, graph, consumer_ref, editor_threads);
+
+				auto writegraph = [&component](G const &graph, GE const &edited) -> bool
+				{
+					component.graph = std::make_unique<G>(graph);
+					component.edited = std::make_unique<GE>(edited);
+					return false;
+				};
+
+				size_t const k_min = editor.initialize();
+				std::chrono::steady_clock::time_point tinit_2 = std::chrono::steady_clock::now();
+				{
+					std::lock_guard<std::mutex> lock(totals_mutex);
+					time_initialization += std::chrono::duration_cast<std::chrono::duration<double>>(tinit_2 - tinit_1).count();
+				}
+
+				for(size_t k = k_min; !options.k_max || k <= options.k_max; k++)
+				{
+					graph = g_component;
+					std::chrono::steady_clock::time_point tedit_1 = std::chrono::steady_clock::now();
+					bool const solved = editor.edit(k, writegraph);
+					std::chrono::steady_clock::time_point tedit_2 = std::chrono::steady_clock::now();
+					{
+						std::lock_guard<std::mutex> lock(totals_mutex);
+						time_editing += std::chrono::duration_cast<std::chrono::duration<double>>(tedit_2 - tedit_1).count();
+#ifdef STATS
+						// the counters are indexed by the remaining number of edits, sum them level by level
+						for(auto const &stat: editor.stats())
+						{
+							std::vector<size_t> &sum = stats[stat.first];
+							if(sum.size() < stat.second.size()) {sum.resize(stat.second.size(), 0);}
+							for(size_t j = 0; j < stat.second.size(); j++) {sum[j] += stat.second[j];}
+						}
+#endif
+					}
+					if(solved)
+					{
+						component.k = k;
+						component.solved = true;
+						break;
+					}
+					if(stop || (options.time_max && std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - t1).count() >= options.time_max)) {break;}
+				}
+				// one unsolvable component makes the whole graph unsolvable
+				if(!component.solved) {stop = true;}
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for(size_t i = 1; i < workers; i++) {threads.emplace_back(solve);}
+		solve();
+		for(auto &thread: threads) {thread.join();}
+
+		t2 = std::chrono::steady_clock::now();
+		// with several workers the summed times of the components can exceed the wall clock time reported as total
+		double const time_total = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+#ifdef STATS
+		// the components stop at different k, pad all counters to the same number of levels
+		size_t levels = 0;
+		for(auto const &stat: stats) {levels = std::max(levels, stat.second.size());}
+		for(auto &stat: stats) {stat.second.resize(levels, 0);}
+#endif
+
+		bool solved = std::all_of(components.begin(), components.end(), [](Component const &component) {return component.solved;});
+		size_t k = std::accumulate(components.begin(), components.end(), size_t(0), [](size_t sum, Component const &component) {return sum + component.k;});
+		solved &= !options.k_max || k <= options.k_max;
+
+		if(solved && !options.no_write)
+		{
+			// merge the solutions of all components into the whole graph
+			G graph = g_orig;
+			GE edited(g_orig.size());
+			for(auto const &component: components)
+			{
+				auto const &vertices = component.vertices;
+				for(VertexID u = 0; u < vertices.size(); u++)
+				{
+					for(VertexID v = u + 1; v < vertices.size(); v++)
+					{
+						if(component.graph->has_edge(u, v) != g_orig.has_edge(vertices[u], vertices[v])) {graph.toggle_edge(vertices[u], vertices[v]);}
+						if(component.edited->has_edge(u, v)) {edited.set_edge(vertices[u], vertices[v]);}
+					}
+				}
+			}
+
+			std::ostringstream fname;
+			fname << filename << ".e." << name() << ".k" << k << ".w0";
+
+			G graph_orig_ids = Graph::apply_permutation(graph, reverse_permutation);
+			GE edited_orig_ids = Graph::apply_permutation(edited, reverse_permutation);
+			Graph::writeMetis(fname.str(), graph_orig_ids);
+			Graph::writeDot(fname.str() + ".gv", graph_orig_ids);
+			Graph::writeMetis(fname.str() + ".edits", edited_orig_ids);
+			Graph::writeDot(fname.str() + ".edits.gv", edited_orig_ids);
+			Graph::writeDotCombined(fname.str() + ".combined.gv", graph_orig_ids, edited_orig_ids, input_graph);
+		}
+
+		size_t largest = components.empty() ? 0 : components.front().vertices.size();
+		if(options.stats_json)
+		{
+			std::ostringstream json;
+			json << "{\"type\":\"exact\",\"graph\":\"" << filename << "\",\"permutation\":" << options.permutation << ",";
+			json << "\"n\":" << static_cast<size_t>(input_graph.size()) << ",\"m\":" << input_graph.count_edges() << ",";
+			json << "\"algo\":\"" << name() << "\",\"threads\":" << +options.threads << ",\"k\":" << +k << ",";
+			json << "\"all_solutions\":\"false\",\"components\":" << components.size() << ",\"largest_component\":" << largest << ",";
+			json << "\"results\":{\"solved\":\"" << (solved? "true" : "false") << "\",\"time\":" << time_editing;
+			json << ",\"time_initialization\":" << time_initialization;
+			json << ",\"total_time\":" << time_total;
+			json << ",\"solutions\":" << (solved ? 1 : 0);
+#ifdef STATS
+			write_stats_json(json, stats);
+#endif
+			json << "}},\n";
+			std::cout << json.str() << std::flush;
+		}
+		else
+		{
+#ifdef STATS
+			if(!stats.empty() && levels > 0)
+			{
+				std::cout << '\n' << filename << " (permutation: " << options.permutation << "): (exact) " << name() << ", " << +options.threads << " threads, " << components.size() << " components, counters summed over all components\n";
+				write_stats_table(std::cout, stats);
+			}
+#endif
+			std::cout << filename << " (permutation: " << options.permutation << "): (exact) " << name() << ", " << +options.threads << " threads, " << components.size() << " components (largest " << largest << "), k = " << +k << ": " << (solved ? "yes" : "no") << " [" << time_editing << "s + initialization " << time_initialization << "s, " << time_total << "s total]\n";
+			std::cout << std::flush;
+		}
+	}
+
+#ifdef STATS
+	/** Appends the per level counters in @a stats to @a json as the object "counters" */
+	template<typename S>
+	static void write_stats_json(std::ostream &json, S const &stats)
+	{
+		json << ",\"counters\":{";
+		bool first_stat = true;
+		for(auto stat : stats)
+		{
+			json << (first_stat? "" : ",") << "\"" << stat.first << "\":[";
+			first_stat = false;
+			bool first_value = true;
+			for(auto value : stat.second)
+			{
+				json << (first_value? "" : ",") << +value;
+				first_value = false;
+			}
+			json << ']';
+		}
+		json << '}';
+	}
+
+	/** Prints the per level counters in @a stats as a table with aligned columns, @a stats must not be empty */
+	template<typename S>
+	static void write_stats_table(std::ostream &out, S const &stats)
+	{
+		std::map<std::string, std::ostringstream> output;
+		{
+			// header cloumn: find longest name
+			size_t l = std::max_element(stats.begin(), stats.end(), [](auto const &a, auto const &b)
+			{
+				return a.first.length() < b.first.length();
+			})->first.length();
+			for(auto const &stat: stats)
+			{
+				output[stat.first] << std::setw(l) << stat.first << ':';
+			}
+			output["k"] << std::setw(l) << "k" << ':';
+		}
+		for(size_t j = 0; j < stats.begin()->second.size(); j++)
+		{
+			// data columns: find largest number
+			size_t m = std::max(j, std::max_element(stats.begin(), stats.end(), [&j](auto const &a, auto const &b)
+			{
+				return a.second[j] < b.second[j];
+			})->second[j]);
+			// figure out charakters needed to print it [ ceil(log_10(m)) ]
+			size_t l = 0;
+			do
+			{
+				m /= 10;
+				l++;
+			}
+			while(m > 0);
+			for(auto const &stat: stats)
+			{
+				output[stat.first] << " " << std::setw(l) << +stat.second[j];
+			}
+			output["k"] << " " << std::setw(l) << +j;
+		}
+		out << output["k"].str() << '\n';
+		for(auto const &stat: stats)
+		{
+			out << output[stat.first].str() << ", total: " << +std::accumulate(stat.second.begin(), stat.second.end(), 0) << '\n';
+		}
+	}
+#endif
+
+	/** The lower bound parameters for a share of the graph: the MIS search gets at most a tenth of the time limit, split by the share */
+	static Lower_Bound::Parameters bound_parameters(CMDOptions const &options, double share)
+	{
+		Lower_Bound::Parameters parameters = options.bound;
+		if(options.time_max) {parameters.mis_time = std::min(parameters.mis_time, options.time_max / 10.0);}
+		parameters.mis_time *= share;
+		return parameters;
+	}
+
+	/** Passes the lower bound parameters to the consumers tagged with Options::Tag::Parameters */
+	template<typename Consumers>
+	static void set_parameters(Consumers &consumer, Lower_Bound::Parameters const &parameters)
+	{
+		Util::for_<std::tuple_size<Consumers>::value>([&](auto i)
+		{
+			if constexpr (std::is_base_of<Options::Tag::Parameters, std::tuple_element_t<i.value, Consumers>>::value)
+			{
+				std::get<i.value>(consumer).set_parameters(parameters);
+			}
+		});
+	}
+
 	static std::string name()
 	{
 		/* Editor must be valid to be able to access Editor::name */
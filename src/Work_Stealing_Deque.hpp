@@ -0,0 +1,121 @@
+#ifndef WORK_STEALING_DEQUE_HPP
+#define WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/** Lock-free deque of owned pointers after Chase and Lev, in the C11 formulation of Lê et al. (PPoPP 2013).
+ * Only the owning thread may push() and pop() at the bottom, any thread may steal() the oldest element from the top.
+ * Elements still in the deque are deleted with it.
+ */
+template<typename T>
+class Work_Stealing_Deque
+{
+	struct Buffer
+	{
+		int64_t capacity;
+		std::unique_ptr<std::atomic<T *>[]> items;
+
+		Buffer(int64_t capacity) : capacity(capacity), items(new std::atomic<T *>[capacity]) {}
+
+		T *get(int64_t i) const {return items[i & (capacity - 1)].load(std::memory_order_relaxed);}
+		void put(int64_t i, T *item) {items[i & (capacity - 1)].store(item, std::memory_order_relaxed);}
+	};
+
+	alignas(64) std::atomic<int64_t> top;
+	alignas(64) std::atomic<int64_t> bottom;
+	std::atomic<Buffer *> buffer;
+	/* outgrown buffers may still be read by thieves, so they are only freed with the deque */
+	std::vector<std::unique_ptr<Buffer>> buffers;
+
+public:
+	Work_Stealing_Deque(int64_t capacity = 64) : top(0), bottom(0)
+	{
+		assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+		buffers.push_back(std::make_unique<Buffer>(capacity));
+		buffer.store(buffers.back().get(), std::memory_order_relaxed);
+	}
+
+	Work_Stealing_Deque(Work_Stealing_Deque const &) = delete;
+	Work_Stealing_Deque &operator=(Work_Stealing_Deque const &) = delete;
+
+	~Work_Stealing_Deque()
+	{
+		while(pop()) {;}
+	}
+
+	/** Owner only */
+	void push(std::unique_ptr<T> item)
+	{
+		int64_t b = bottom.load(std::memory_order_relaxed);
+		int64_t t = top.load(std::memory_order_acquire);
+		Buffer *a = buffer.load(std::memory_order_relaxed);
+		if(b - t > a->capacity - 1) {a = grow(a, t, b);}
+		a->put(b, item.release());
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	/** Owner only, returns the newest element or nullptr */
+	std::unique_ptr<T> pop()
+	{
+		int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		Buffer *a = buffer.load(std::memory_order_relaxed);
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+
+		T *item = nullptr;
+		if(t <= b)
+		{
+			item = a->get(b);
+			if(t == b)
+			{
+				// last element, race against thieves
+				if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {item = nullptr;}
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+		}
+		else
+		{
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return std::unique_ptr<T>(item);
+	}
+
+	/** Any thread, returns the oldest element or nullptr if the deque is empty or another thread was faster */
+	std::unique_ptr<T> steal()
+	{
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t b = bottom.load(std::memory_order_acquire);
+		if(t >= b) {return nullptr;}
+
+		T *item = buffer.load(std::memory_order_acquire)->get(t);
+		if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {return nullptr;}
+		return std::unique_ptr<T>(item);
+	}
+
+	/** Only a hint while other threads steal */
+	size_t size() const
+	{
+		int64_t b = bottom.load(std::memory_order_relaxed);
+		int64_t t = top.load(std::memory_order_relaxed);
+		return b > t ? b - t : 0;
+	}
+
+private:
+	Buffer *grow(Buffer *a, int64_t t, int64_t b)
+	{
+		buffers.push_back(std::make_unique<Buffer>(2 * a->capacity));
+		Buffer *grown = buffers.back().get();
+		for(int64_t i = t; i < b; i++) {grown->put(i, a->get(i));}
+		buffer.store(grown, std::memory_order_release);
+		return grown;
+	}
+};
+
+#endif
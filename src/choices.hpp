@@ -30,6 +30,8 @@
 #include "Consumer/LB_Gurobi.hpp"
 #include "Consumer/LB_Min_Deg.hpp"
 #include "Consumer/LB_ARW.hpp"
+#include "Consumer/LB_MIS.hpp"
+#include "Consumer/LB_MWU.hpp"
 /*
 #include "Consumer/LB_Global_ARW.hpp"
 #include "Consumer/LB_KaMIS.hpp"
@@ -37,5 +39,7 @@
 #include "Consumer/Counter.hpp"
 */
 #include "Graph/Matrix.hpp"
+#include "Graph/Hybrid.hpp"
+#include "Graph/PairSet.hpp"
 
 #endif
@@ -9,6 +9,8 @@
 
 /* Type used for vertex identifiers */
 using VertexID = uint16_t;
+/* Type used for vertex identifiers of graphs with more vertices than VertexID can address, selected automatically when loading the graph */
+using VertexID_Large = uint32_t;
 /* Type used for adjecency matrices */
 using Packed = uint64_t;
 /* Numer of bits in Packed */
@@ -33,9 +35,9 @@ constexpr size_t Packed_Bits = sizeof(Packed) * 8;
 #define CHOICES_HEURISTIC
 #define CHOICES_FINDER Center_P3, Center_P4, Center_P5, Center_4, Center_5
 #define CHOICES_CONSUMER_SELECTOR First, Most, Most_Pruned, Single_Most
-#define CHOICES_CONSUMER_BOUND No, Basic, ARW
+#define CHOICES_CONSUMER_BOUND No, Basic, ARW, MIS, MWU
 #define CHOICES_CONSUMER_RESULT
-#define CHOICES_GRAPH Matrix
+#define CHOICES_GRAPH Matrix, Hybrid
 #else
 #define CHOICES_MODE Edit
 #define CHOICES_RESTRICTION /*None, Undo,*/ Redundant
@@ -44,9 +46,9 @@ constexpr size_t Packed_Bits = sizeof(Packed) * 8;
 #define CHOICES_HEURISTIC
 #define CHOICES_FINDER /*Center_P3, Center_P4, Center_P5,*/ Center_4/*, Center_5, Center_6*/
 #define CHOICES_CONSUMER_SELECTOR  First, Most, Most_Pruned/*, Gurobi, Single_Most*/
-#define CHOICES_CONSUMER_BOUND /*No,*/ ARW, Basic, Updated, Min_Deg, Gurobi
+#define CHOICES_CONSUMER_BOUND /*No,*/ ARW, MIS, Basic, Updated, Min_Deg, MWU, Gurobi
 #define CHOICES_CONSUMER_RESULT
-#define CHOICES_GRAPH Matrix
+#define CHOICES_GRAPH Matrix, Hybrid
 #endif
 
 /* Macros used by choices.py defining which components can be combined and in which order
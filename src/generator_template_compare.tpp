@@ -6,5 +6,9 @@ else if(editor == "{0}" && mode == "{3}" && restriction == "{4}" && conversion =
 	using M = Options::Modes::{3}; \
 	using R = Options::Restrictions::{4}; \
 	using C = Options::Conversions::{5}; \
-	Run<Editor::{0}, Finder::{1}, Graph::{2}, Graph::Matrix, M, R, C, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>::run(options, filename); \
+	if(large_ids) Run<Editor::{0}, Finder::{1}, Graph::{2}_Impl<VertexID_Large>, Graph::Pair_Set_Impl<VertexID_Large>, M, R, C, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>::run(options, filename); \
+	else if(fixed_row_length == 1) Run<Editor::{0}, Finder::{1}, Graph::{2}_Impl<VertexID, 1>, Graph::Pair_Set_Impl<VertexID, 1>, M, R, C, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>::run(options, filename); \
+	else if(fixed_row_length == 2) Run<Editor::{0}, Finder::{1}, Graph::{2}_Impl<VertexID, 2>, Graph::Pair_Set_Impl<VertexID, 2>, M, R, C, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>::run(options, filename); \
+	else if(fixed_row_length == 4) Run<Editor::{0}, Finder::{1}, Graph::{2}_Impl<VertexID, 4>, Graph::Pair_Set_Impl<VertexID, 4>, M, R, C, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>::run(options, filename); \
+	else Run<Editor::{0}, Finder::{1}, Graph::{2}, Graph::Pair_Set, M, R, C, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>::run(options, filename); \
 =)= \
@@ -3,4 +3,8 @@
 #include "../../src/choices.hpp"
 #include "../../src/Run_impl.hpp"
 
-template struct Run<Editor::{0}, Finder::{1}, Graph::{2}, Graph::Matrix, Options::Modes::{3}, Options::Restrictions::{4}, Options::Conversions::{5}, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>;
+template struct Run<Editor::{0}, Finder::{1}, Graph::{2}, Graph::Pair_Set, Options::Modes::{3}, Options::Restrictions::{4}, Options::Conversions::{5}, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>;
+template struct Run<Editor::{0}, Finder::{1}, Graph::{2}_Impl<VertexID, 1>, Graph::Pair_Set_Impl<VertexID, 1>, Options::Modes::{3}, Options::Restrictions::{4}, Options::Conversions::{5}, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>;
+template struct Run<Editor::{0}, Finder::{1}, Graph::{2}_Impl<VertexID, 2>, Graph::Pair_Set_Impl<VertexID, 2>, Options::Modes::{3}, Options::Restrictions::{4}, Options::Conversions::{5}, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>;
+template struct Run<Editor::{0}, Finder::{1}, Graph::{2}_Impl<VertexID, 4>, Graph::Pair_Set_Impl<VertexID, 4>, Options::Modes::{3}, Options::Restrictions::{4}, Options::Conversions::{5}, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>;
+template struct Run<Editor::{0}, Finder::{1}, Graph::{2}_Impl<VertexID_Large>, Graph::Pair_Set_Impl<VertexID_Large>, Options::Modes::{3}, Options::Restrictions::{4}, Options::Conversions::{5}, Consumer::{6}, Consumer::{7}{8:.., Consumer::.}>;
@@ -2,6 +2,7 @@
 #include <string.h>
 
 #include <iostream>
+#include <limits>
 #include <map>
 #include <numeric>
 #include <set>
@@ -21,6 +22,22 @@ void run(CMDOptions const &options)
 {
 	for(auto const &filename : options.filenames)
 	{
+		// graphs with more vertices than VertexID can address use the instantiation with VertexID_Large
+		// small graphs use the instantiation with the shortest fixed row length they fit into
+		bool large_ids;
+		size_t fixed_row_length;
+		try
+		{
+			uint64_t n = Graph::get_size(filename, options.edgelist);
+			large_ids = n > std::numeric_limits<VertexID>::max();
+			fixed_row_length = large_ids ? 0 : Graph::select_fixed_row_length(n);
+		}
+		catch(std::exception const &e)
+		{
+			std::cerr << e.what() << std::endl;
+			continue;
+		}
+
 		for(auto const &e: options.combinations_edit) for(auto const &m: e.second) for(auto const &r: m.second) for(auto const &c: r.second) for(auto const &f: c.second) for(auto const &g: f.second) for(auto const &consumers: g.second)
 		{{
 			auto const &editor = e.first;
@@ -55,6 +72,8 @@ int main(int argc, char *argv[])
 		{"kmin", required_argument, NULL, 'k'},
 		{"kmax", required_argument, NULL, 'K'},
 		{"all", no_argument, NULL, 'a'},
+		{"split-components", no_argument, NULL, 'S'},
+		{"bound", required_argument, NULL, 'b'},
 		// time
 		{"time", required_argument, NULL, 't'},
 		{"time-hard", required_argument, NULL, 'T'},
@@ -64,6 +83,7 @@ int main(int argc, char *argv[])
 		// input
 		{"edgelist", no_argument, NULL, 'l'},
 		{"permutation", required_argument, NULL, 'P'},
+		{"no-cache", no_argument, NULL, 'B'},
 		// output
 		{"no-write", no_argument, NULL, 'W'},
 		{"json", no_argument, NULL, 'J'},
@@ -87,7 +107,7 @@ int main(int argc, char *argv[])
 
 		{NULL, 0, NULL, 0}
 	};
-	char const *shortopts = "?k:K:at:T:j:n:N:lP:WSJDX:{,}M:R:C:e:h:f:c:g:_";
+	char const *shortopts = "?k:K:ab:t:T:j:n:N:lP:BWSJDX:{,}M:R:C:e:h:f:c:g:_";
 
 	CMDOptions options;
 	bool usage = false;
@@ -194,6 +214,20 @@ int main(int argc, char *argv[])
 		case 'a':
 			options.all_solutions = true;
 			break;
+		case 'S':
+			options.split_components = true;
+			break;
+		case 'b':
+		{
+			std::string const assignment(optarg);
+			size_t const eq = assignment.find('=');
+			if(eq == std::string::npos || !options.bound.set(assignment.substr(0, eq), assignment.substr(eq + 1)))
+			{
+				std::cerr << "Invalid lower bound parameter \"" << assignment << "\" [-b]" << std::endl;
+				usage = true;
+			}
+			break;
+		}
 		case 't':
 			options.time_max = std::stoull(optarg);
 			break;
@@ -215,6 +249,9 @@ int main(int argc, char *argv[])
 		case 'P':
 			options.permutation = std::stoull(optarg);
 			break;
+		case 'B':
+			options.graph_cache = false;
+			break;
 		case 'W':
 			options.no_write = true;
 			break;
@@ -289,7 +326,11 @@ int main(int argc, char *argv[])
 			<< "  -D --warmup: Spend some time before each set of experiments in dry-runs\n"
 			<< "  -l --edge-list: Graph is in edge list format \n"
 			<< "  -P --permutation <number>: Seed for the random permutation of node ids, 0 (default) disables permutation. \n"
+			<< "  -B --no-cache: Always parse the graph instead of using or creating the binary cache <graph>.bgraph\n"
 			<< "  -a --all: Find all solutions, not just the first one\n"
+			<< "  -S --split-components: Solve connected components independently and in parallel, k is the sum over all components\n"
+			<< "  -b --bound <name>=<value>: Set a tuning parameter of the lower bounds, these are (with defaults):\n"
+			<< Lower_Bound::Parameters::usage()
 			<< "  -W --no-write: Do not write solutions to disk\n"
 			<< "  -J --json: Output results as JSON fragment\n\n"
 			<< "  -e --editor / -h --heuristic / -f --finder / -c --consumer / -g --graph / -M --mode / -C --conversion / -R --restriction:\n"
@@ -305,6 +346,16 @@ int main(int argc, char *argv[])
 		std::cerr << "Can't run without threads [-j < 1]" << std::endl;
 		usage = true;
 	}
+	if(options.split_components && options.all_solutions)
+	{
+		std::cerr << "Can't enumerate all solutions of independently solved components [-S and -a]" << std::endl;
+		usage = true;
+	}
+	if(options.split_components && options.k_min)
+	{
+		std::cerr << "Can't start independently solved components at a common minimum k [-S and -k]" << std::endl;
+		usage = true;
+	}
 
 	size_t combination_count = 0;
 	bool no_groups = true;